@@ -0,0 +1,67 @@
+// Measures pcm::convertS32ToS16 against the scalar loop and checks that both give the same samples.
+// It is not part of the danttoUHD project and is built on its own, for example:
+//   cl /O2 /EHsc /std:c++17 pcmConvertBench.cpp ..\src\pcmConvert.cpp
+//   g++ -O2 -std=c++17 pcmConvertBench.cpp ../src/pcmConvert.cpp -o pcmConvertBench
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "../src/pcmConvert.h"
+
+namespace {
+
+using ConvertFunction = void (*)(const int32_t*, int16_t*, size_t);
+
+// A frame of 1024 samples for 16 channels
+constexpr size_t sampleCount = 1024 * 16;
+constexpr int iterations = 20000;
+
+double measure(ConvertFunction function, const std::vector<int32_t>& input, std::vector<int16_t>& output) {
+    // Warms up the caches and the branch predictor
+    for (int i = 0; i < 100; i++) {
+        function(input.data(), output.data(), input.size());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        function(input.data(), output.data(), input.size());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(input.size()) * iterations / seconds / 1e6;
+}
+
+}
+
+int main() {
+    std::mt19937 random(1);
+    std::vector<int32_t> input(sampleCount);
+    for (auto& sample : input) {
+        sample = static_cast<int32_t>(random());
+    }
+    input[0] = INT32_MIN;
+    input[1] = INT32_MAX;
+    input[2] = -1;
+
+    std::vector<int16_t> expected(sampleCount);
+    std::vector<int16_t> output(sampleCount);
+    // Odd lengths end in the tails of the vector kernels
+    for (size_t count : { size_t{ 0 }, size_t{ 1 }, size_t{ 7 }, size_t{ 15 }, size_t{ 17 }, size_t{ 33 }, sampleCount }) {
+        pcm::convertS32ToS16Scalar(input.data(), expected.data(), count);
+        pcm::convertS32ToS16(input.data(), output.data(), count);
+        if (memcmp(expected.data(), output.data(), count * sizeof(int16_t)) != 0) {
+            fprintf(stderr, "The %s kernel differs from the scalar loop for %zu samples\n", pcm::getConvertKernelName(), count);
+            return 1;
+        }
+    }
+
+    double scalar = measure(pcm::convertS32ToS16Scalar, input, output);
+    double dispatched = measure(pcm::convertS32ToS16, input, output);
+
+    printf("scalar: %.0f Msamples/s\n", scalar);
+    printf("%s: %.0f Msamples/s (%.2fx)\n", pcm::getConvertKernelName(), dispatched, dispatched / scalar);
+    return 0;
+}
@@ -1,140 +1,189 @@
-#include "aacEncoder.h"
-
-int AacEncoder::encode(const std::vector<uint8_t>& input, std::vector<std::vector<uint8_t>>& output) {
-	wav = wav_read_open(input);
-	if (!inited) {
-		if (!wav) {
-			return 1;
-		}
-		if (!wav_get_header(wav, &format, &channels, &sample_rate, &bits_per_sample, NULL)) {
-			return 1;
-		}
-		if (format != 1) {
-			fprintf(stderr, "Unsupported WAV format %d\n", format);
-			return 1;
-		}
-		if (bits_per_sample != 16) {
-			fprintf(stderr, "Unsupported WAV sample depth %d\n", bits_per_sample);
-			return 1;
-		}
-		if (aacEncOpen(&handle, 0, channels) != AACENC_OK) {
-			fprintf(stderr, "Unable to open encoder\n");
-			return 1;
-		}
-		if (aacEncoder_SetParam(handle, AACENC_AOT, aot) != AACENC_OK) {
-			fprintf(stderr, "Unable to set the AOT\n");
-			return 1;
-		}
-		if (aot == 39 && eld_sbr) {
-			if (aacEncoder_SetParam(handle, AACENC_SBR_MODE, 1) != AACENC_OK) {
-				fprintf(stderr, "Unable to set SBR mode for ELD\n");
-				return 1;
-			}
-		}
-		if (aacEncoder_SetParam(handle, AACENC_SAMPLERATE, sample_rate) != AACENC_OK) {
-			fprintf(stderr, "Unable to set the sample rate\n");
-			return 1;
-		}
-		if (aacEncoder_SetParam(handle, AACENC_CHANNELMODE, channels) != AACENC_OK) {
-			fprintf(stderr, "Unable to set the channel mode\n");
-			return 1;
-		}
-		if (aacEncoder_SetParam(handle, AACENC_CHANNELORDER, 1) != AACENC_OK) {
-			fprintf(stderr, "Unable to set the wav channel order\n");
-			return 1;
-		}
-		if (vbr) {
-			if (aacEncoder_SetParam(handle, AACENC_BITRATEMODE, vbr) != AACENC_OK) {
-				fprintf(stderr, "Unable to set the VBR bitrate mode\n");
-				return 1;
-			}
-		}
-		else {
-			if (aacEncoder_SetParam(handle, AACENC_BITRATE, bitrate * 2 * channels) != AACENC_OK) {
-				fprintf(stderr, "Unable to set the bitrate\n");
-				return 1;
-			}
-		}
-		if (aacEncoder_SetParam(handle, AACENC_TRANSMUX, TT_MP4_ADTS) != AACENC_OK) {
-			fprintf(stderr, "Unable to set the ADTS transmux\n");
-			return 1;
-		}
-		if (aacEncoder_SetParam(handle, AACENC_AFTERBURNER, afterburner) != AACENC_OK) {
-			fprintf(stderr, "Unable to set the afterburner mode\n");
-			return 1;
-		}
-		if (aacEncEncode(handle, NULL, NULL, NULL, NULL) != AACENC_OK) {
-			fprintf(stderr, "Unable to initialize the encoder\n");
-			return 1;
-		}
-		if (aacEncInfo(handle, &info) != AACENC_OK) {
-			fprintf(stderr, "Unable to get the encoder info\n");
-			return 1;
-		}
-		inited = true;
-	}
-
-	input_size = channels * 2 * info.frameLength;
-	input_buf = (uint8_t*)malloc(input_size);
-	convert_buf = (int16_t*)malloc(input_size);
-
-	while (1) {
-		AACENC_BufDesc in_buf = { 0 }, out_buf = { 0 };
-		AACENC_InArgs in_args = { 0 };
-		AACENC_OutArgs out_args = { 0 };
-		int in_identifier = IN_AUDIO_DATA;
-		int in_size, in_elem_size;
-		int out_identifier = OUT_BITSTREAM_DATA;
-		int out_size, out_elem_size;
-		int read, i;
-		void* in_ptr, * out_ptr;
-		uint8_t outbuf[20480];
-		AACENC_ERROR err;
-
-		read = wav_read_data(wav, input_buf, input_size);
-		for (i = 0; i < read / 2; i++) {
-			const uint8_t* in = &input_buf[2 * i];
-			convert_buf[i] = in[0] | (in[1] << 8);
-		}
-		in_ptr = convert_buf;
-		in_size = read;
-		in_elem_size = 2;
-
-		in_args.numInSamples = read <= 0 ? -1 : read / 2;
-		in_buf.numBufs = 1;
-		in_buf.bufs = &in_ptr;
-		in_buf.bufferIdentifiers = &in_identifier;
-		in_buf.bufSizes = &in_size;
-		in_buf.bufElSizes = &in_elem_size;
-
-		out_ptr = outbuf;
-		out_size = sizeof(outbuf);
-		out_elem_size = 1;
-		out_buf.numBufs = 1;
-		out_buf.bufs = &out_ptr;
-		out_buf.bufferIdentifiers = &out_identifier;
-		out_buf.bufSizes = &out_size;
-		out_buf.bufElSizes = &out_elem_size;
-
-		if ((err = aacEncEncode(handle, &in_buf, &out_buf, &in_args, &out_args)) != AACENC_OK) {
-			if (err == AACENC_ENCODE_EOF)
-				break;
-			fprintf(stderr, "Encoding failed\n");
-			return 1;
-		}
-		if (out_args.numOutBytes == 0)
-			continue;
-
-		output.emplace_back(outbuf, outbuf + out_args.numOutBytes);
-	}
-
-	free(input_buf);
-	free(convert_buf);
-
-	return 0;
-}
-
-void AacEncoder::close() {
-	wav_read_close(wav);
-	aacEncClose(&handle);
-}
+#include "aacEncoder.h"
+
+int AacEncoder::encode(PcmBuffer& input, std::vector<AacFrame>& output) {
+	// The samples the encoder holds belong to the old timeline, so they are encoded with the old
+	// base before the encoder starts over and takes the new one
+	bool discontinuity = input.takeDiscontinuity();
+	if (inited && discontinuity) {
+		flush(output);
+		close();
+		has_base_pts = false;
+	}
+
+	// The encoder follows the rendered layout, so it is reopened when that changes
+	if (inited && (input.getChannels() != static_cast<uint32_t>(channels) || input.getSampleRate() != static_cast<uint32_t>(sample_rate))) {
+		close();
+		has_base_pts = false;
+	}
+	if (!inited) {
+		if (input.getChannels() == 0 || input.getSize() == 0) {
+			return 0;
+		}
+		channels = input.getChannels();
+		sample_rate = input.getSampleRate();
+		if (aacEncOpen(&handle, 0, channels) != AACENC_OK) {
+			fprintf(stderr, "Unable to open encoder\n");
+			return 1;
+		}
+		if (aacEncoder_SetParam(handle, AACENC_AOT, aot) != AACENC_OK) {
+			fprintf(stderr, "Unable to set the AOT\n");
+			return 1;
+		}
+		if (aot == 39 && eld_sbr) {
+			if (aacEncoder_SetParam(handle, AACENC_SBR_MODE, 1) != AACENC_OK) {
+				fprintf(stderr, "Unable to set SBR mode for ELD\n");
+				return 1;
+			}
+		}
+		if (aacEncoder_SetParam(handle, AACENC_SAMPLERATE, sample_rate) != AACENC_OK) {
+			fprintf(stderr, "Unable to set the sample rate\n");
+			return 1;
+		}
+		if (aacEncoder_SetParam(handle, AACENC_CHANNELMODE, channels) != AACENC_OK) {
+			fprintf(stderr, "Unable to set the channel mode\n");
+			return 1;
+		}
+		if (aacEncoder_SetParam(handle, AACENC_CHANNELORDER, 1) != AACENC_OK) {
+			fprintf(stderr, "Unable to set the wav channel order\n");
+			return 1;
+		}
+		if (vbr) {
+			if (aacEncoder_SetParam(handle, AACENC_BITRATEMODE, vbr) != AACENC_OK) {
+				fprintf(stderr, "Unable to set the VBR bitrate mode\n");
+				return 1;
+			}
+		}
+		else {
+			if (aacEncoder_SetParam(handle, AACENC_BITRATE, bitrate * 2 * channels) != AACENC_OK) {
+				fprintf(stderr, "Unable to set the bitrate\n");
+				return 1;
+			}
+		}
+		if (aacEncoder_SetParam(handle, AACENC_TRANSMUX, TT_MP4_ADTS) != AACENC_OK) {
+			fprintf(stderr, "Unable to set the ADTS transmux\n");
+			return 1;
+		}
+		if (aacEncoder_SetParam(handle, AACENC_AFTERBURNER, afterburner) != AACENC_OK) {
+			fprintf(stderr, "Unable to set the afterburner mode\n");
+			return 1;
+		}
+		if (aacEncEncode(handle, NULL, NULL, NULL, NULL) != AACENC_OK) {
+			fprintf(stderr, "Unable to initialize the encoder\n");
+			return 1;
+		}
+		if (aacEncInfo(handle, &info) != AACENC_OK) {
+			fprintf(stderr, "Unable to get the encoder info\n");
+			return 1;
+		}
+		outbuf.resize(20480);
+		inited = true;
+	}
+
+	if (discontinuity || !has_base_pts) {
+		// The first frame carries the encoder delay, so it starts that much earlier
+		uint64_t delay = static_cast<uint64_t>(info.nDelay) * 90000 / sample_rate;
+		uint64_t timestamp = input.getTimestamp();
+		base_pts = timestamp > delay ? timestamp - delay : 0;
+		frames_since_base = 0;
+		has_base_pts = true;
+	}
+
+	while (1) {
+		size_t count;
+		const int16_t* samples = input.peek(count);
+		if (count == 0) {
+			break;
+		}
+
+		AACENC_OutArgs out_args = { 0 };
+		if (encodeBuffer(const_cast<int16_t*>(samples), static_cast<int>(count * sizeof(int16_t)), static_cast<int>(count), out_args) != 0) {
+			return 1;
+		}
+		input.consume(out_args.numInSamples);
+
+		if (out_args.numOutBytes > 0) {
+			uint64_t pts = base_pts + frames_since_base * info.frameLength * 90000 / sample_rate;
+			output.push_back({ std::vector<uint8_t>(outbuf.data(), outbuf.data() + out_args.numOutBytes), pts });
+			++frames_since_base;
+		}
+		else if (out_args.numInSamples == 0) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+int AacEncoder::flush(std::vector<AacFrame>& output) {
+	if (!inited) {
+		return 0;
+	}
+
+	while (1) {
+		AACENC_OutArgs out_args = { 0 };
+		// No input samples ask the encoder to write out what it still holds
+		int err = encodeBuffer(NULL, 0, -1, out_args);
+		if (err != 0 || out_args.numOutBytes == 0) {
+			return err;
+		}
+
+		uint64_t pts = base_pts + frames_since_base * info.frameLength * 90000 / sample_rate;
+		output.push_back({ std::vector<uint8_t>(outbuf.data(), outbuf.data() + out_args.numOutBytes), pts });
+		++frames_since_base;
+	}
+}
+
+int AacEncoder::encodeBuffer(void* in_ptr, int in_size, int num_in_samples, AACENC_OutArgs& out_args) {
+	AACENC_BufDesc in_buf = { 0 }, out_buf = { 0 };
+	AACENC_InArgs in_args = { 0 };
+	int in_identifier = IN_AUDIO_DATA;
+	int in_elem_size = sizeof(int16_t);
+	int out_identifier = OUT_BITSTREAM_DATA;
+	int out_size, out_elem_size;
+	void* out_ptr;
+	AACENC_ERROR err;
+
+	in_args.numInSamples = num_in_samples;
+	in_buf.numBufs = 1;
+	in_buf.bufs = &in_ptr;
+	in_buf.bufferIdentifiers = &in_identifier;
+	in_buf.bufSizes = &in_size;
+	in_buf.bufElSizes = &in_elem_size;
+
+	out_ptr = outbuf.data();
+	out_size = static_cast<int>(outbuf.size());
+	out_elem_size = 1;
+	out_buf.numBufs = 1;
+	out_buf.bufs = &out_ptr;
+	out_buf.bufferIdentifiers = &out_identifier;
+	out_buf.bufSizes = &out_size;
+	out_buf.bufElSizes = &out_elem_size;
+
+	err = aacEncEncode(handle, &in_buf, &out_buf, &in_args, &out_args);
+	if (err == AACENC_ENCODE_EOF) {
+		return 0;
+	}
+	if (err != AACENC_OK) {
+		fprintf(stderr, "Encoding failed\n");
+		return 1;
+	}
+	return 0;
+}
+
+void AacEncoder::close() {
+	if (inited) {
+		aacEncClose(&handle);
+		inited = false;
+	}
+}
+
+void AacEncoder::setAfterburner(int afterburner) {
+	if (this->afterburner == afterburner) {
+		return;
+	}
+	this->afterburner = afterburner;
+
+	if (inited && aacEncoder_SetParam(handle, AACENC_AFTERBURNER, afterburner) != AACENC_OK) {
+		fprintf(stderr, "Unable to set the afterburner mode\n");
+	}
+}
\ No newline at end of file
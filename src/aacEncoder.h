@@ -1,33 +1,44 @@
-#pragma once
-#include <cstdio>
-#include <cstdint>
-#include <vector>
-extern "C" {
-#include <aacenc_lib.h>
-}
-#include "wavreader.h"
-
-class AacEncoder {
-public:
-	int encode(const std::vector<uint8_t>& input, std::vector<std::vector<uint8_t>>& output);
-	void close();
-
-public:
-	bool inited = false;
-	int bitrate = 64000;
-	int ch;
-	const char* infile, * outfile;
-	FILE* out;
-	void* wav;
-	int format, sample_rate, channels, bits_per_sample;
-	int input_size;
-	uint8_t* input_buf;
-	int16_t* convert_buf;
-	int aot = 2;
-	int afterburner = 1;
-	int eld_sbr = 0;
-	int vbr = 0;
-	HANDLE_AACENCODER handle;
-	AACENC_InfoStruct info = { 0 };
-
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+extern "C" {
+#include <aacenc_lib.h>
+}
+#include "pcmBuffer.h"
+
+struct AacFrame {
+	std::vector<uint8_t> data;
+	uint64_t pts;
+};
+
+class AacEncoder {
+public:
+	// Encodes every complete frame in the buffer; the remainder stays for the next call
+	int encode(PcmBuffer& input, std::vector<AacFrame>& output);
+	void close();
+	// Encodes what the encoder still holds, at the current base PTS
+	int flush(std::vector<AacFrame>& output);
+	// Takes effect from the next frame without reopening the encoder
+	void setAfterburner(int afterburner);
+
+public:
+	bool inited = false;
+	int bitrate = 64000;
+	int sample_rate, channels;
+	int aot = 2;
+	int afterburner = 1;
+	int eld_sbr = 0;
+	int vbr = 0;
+	HANDLE_AACENCODER handle;
+	AACENC_InfoStruct info = { 0 };
+
+private:
+	int encodeBuffer(void* in_ptr, int in_size, int num_in_samples, AACENC_OutArgs& out_args);
+
+	std::vector<uint8_t> outbuf;
+	uint64_t base_pts = 0;
+	uint64_t frames_since_base = 0;
+	bool has_base_pts = false;
+
 };
\ No newline at end of file
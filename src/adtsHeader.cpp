@@ -0,0 +1,95 @@
+#include "adtsHeader.h"
+
+namespace {
+
+class BitReader {
+public:
+    BitReader(const std::vector<uint8_t>& data) : data(data) {}
+
+    bool read(uint32_t bits, uint32_t& value) {
+        value = 0;
+        for (uint32_t i = 0; i < bits; i++) {
+            if (pos >= data.size() * 8) {
+                return false;
+            }
+            value = (value << 1) | ((data[pos / 8] >> (7 - pos % 8)) & 1);
+            ++pos;
+        }
+        return true;
+    }
+
+private:
+    const std::vector<uint8_t>& data;
+    size_t pos{ 0 };
+};
+
+bool readAudioObjectType(BitReader& reader, uint32_t& audioObjectType) {
+    if (!reader.read(5, audioObjectType)) {
+        return false;
+    }
+    if (audioObjectType == 31) {
+        uint32_t audioObjectTypeExt;
+        if (!reader.read(6, audioObjectTypeExt)) {
+            return false;
+        }
+        audioObjectType = 32 + audioObjectTypeExt;
+    }
+    return true;
+}
+
+}
+
+bool AdtsHeader::parse(const std::vector<uint8_t>& audioSpecificConfig) {
+    this->audioSpecificConfig = audioSpecificConfig;
+    valid = false;
+
+    BitReader reader(audioSpecificConfig);
+    uint32_t audioObjectType;
+    uint32_t samplingFrequencyIndex;
+    uint32_t channelConfiguration;
+    if (!readAudioObjectType(reader, audioObjectType) ||
+        !reader.read(4, samplingFrequencyIndex) ||
+        samplingFrequencyIndex == 0xF ||
+        !reader.read(4, channelConfiguration)) {
+        return false;
+    }
+
+    // Explicitly signaled SBR/PS: ADTS carries the core configuration and the
+    // decoder detects the extension implicitly
+    if (audioObjectType == 5 || audioObjectType == 29) {
+        uint32_t extensionSamplingFrequencyIndex;
+        if (!reader.read(4, extensionSamplingFrequencyIndex) ||
+            extensionSamplingFrequencyIndex == 0xF ||
+            !readAudioObjectType(reader, audioObjectType)) {
+            return false;
+        }
+    }
+
+    // ADTS has a 2-bit profile (object types 1 to 4) and cannot carry a program config element
+    if (audioObjectType < 1 || audioObjectType > 4 || channelConfiguration == 0) {
+        return false;
+    }
+
+    profile = static_cast<uint8_t>(audioObjectType - 1);
+    this->samplingFrequencyIndex = static_cast<uint8_t>(samplingFrequencyIndex);
+    this->channelConfiguration = static_cast<uint8_t>(channelConfiguration);
+    valid = true;
+    return true;
+}
+
+bool AdtsHeader::write(size_t rawDataSize, std::array<uint8_t, headerSize>& output) const {
+    size_t frameLength = headerSize + rawDataSize;
+    if (!valid || frameLength > 0x1FFF) {
+        return false;
+    }
+
+    // MPEG-4, no CRC, buffer fullness 0x7FF (VBR), one raw data block
+    output[0] = 0xFF;
+    output[1] = 0xF1;
+    output[2] = (profile << 6) | (samplingFrequencyIndex << 2) | ((channelConfiguration >> 2) & 0x1);
+    output[3] = ((channelConfiguration & 0x3) << 6) | static_cast<uint8_t>((frameLength >> 11) & 0x3);
+    output[4] = static_cast<uint8_t>((frameLength >> 3) & 0xFF);
+    output[5] = static_cast<uint8_t>(((frameLength & 0x7) << 5) | 0x1F);
+    output[6] = 0xFC;
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+
+// Builds ADTS headers from an MPEG-4 AudioSpecificConfig so that raw AAC
+// access units can be carried in TS without transcoding.
+class AdtsHeader {
+public:
+    static constexpr size_t headerSize = 7;
+
+    // Returns false if the configuration cannot be expressed in ADTS
+    bool parse(const std::vector<uint8_t>& audioSpecificConfig);
+    bool isValid() const { return valid; }
+    const std::vector<uint8_t>& getAudioSpecificConfig() const { return audioSpecificConfig; }
+
+    // Writes the header for a raw access unit of the given size
+    bool write(size_t rawDataSize, std::array<uint8_t, headerSize>& output) const;
+
+private:
+    std::vector<uint8_t> audioSpecificConfig;
+    bool valid{ false };
+    uint8_t profile{ 0 };
+    uint8_t samplingFrequencyIndex{ 0 };
+    uint8_t channelConfiguration{ 0 };
+
+};
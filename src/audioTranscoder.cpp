@@ -0,0 +1,220 @@
+#include "audioTranscoder.h"
+#include <exception>
+#include <algorithm>
+#include "mpeghDecoder.h"
+#include "rescale.h"
+
+AudioTranscoder::StreamState::~StreamState() {
+    encoder.close();
+}
+
+AudioTranscoder::AudioTranscoder(uint32_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&AudioTranscoder::worker, this);
+    }
+}
+
+AudioTranscoder::~AudioTranscoder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+void AudioTranscoder::setMaxQueuedDuration(uint64_t duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxQueuedDuration = duration;
+}
+
+void AudioTranscoder::submit(uint32_t streamKey, const Quality& quality, uint32_t timescale, const std::vector<StreamPacket>& packets, const Target& target) {
+    if (packets.size() == 0) {
+        return;
+    }
+
+    AVRational r = { 1, static_cast<int>(timescale) };
+    AVRational ts = { 1, 90000 };
+    uint64_t startDts = av_rescale_q(packets.front().dts, r, ts);
+    uint64_t endDts = av_rescale_q(packets.back().dts, r, ts);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto& state = streams[streamKey];
+        if (!state) {
+            state = std::make_unique<StreamState>();
+        }
+
+        // Keeps the demuxer from running ahead of the transcoder, which would leave the audio
+        // arriving at the muxer long after the video with the same DTS
+        StreamState* waiting = state.get();
+        jobDone.wait(lock, [&]() {
+            return waiting->queue.size() == 0 || waiting->submittedDts < waiting->transcodedDts ||
+                waiting->submittedDts - waiting->transcodedDts <= maxQueuedDuration;
+        });
+
+        if (!state->hasDts) {
+            state->transcodedDts = startDts;
+            state->polledPts = startDts;
+            state->hasDts = true;
+        }
+        // An idle stream is not behind, and neither is one whose timestamps went back
+        if (!state->scheduled || startDts < state->submittedDts) {
+            state->clockStart = std::chrono::steady_clock::now();
+            state->clockStartDts = startDts;
+        }
+        state->submittedDts = endDts;
+        state->pid = target.pid;
+        ++state->unpolledJobs;
+
+        state->queue.push_back({ quality, timescale, endDts, packets, target, state->restart });
+        state->restart = false;
+        ++pendingJobs;
+
+        if (state->scheduled) {
+            return;
+        }
+        state->scheduled = true;
+        readyStreams.push_back(streamKey);
+    }
+    workAvailable.notify_one();
+}
+
+void AudioTranscoder::poll(std::vector<Output>& outputs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& output : results) {
+        StreamState& state = *streams[output.streamKey];
+        if (output.frames.size() > 0) {
+            state.polledPts = output.frames.back().pts;
+        }
+        --state.unpolledJobs;
+
+        if (output.frames.size() > 0) {
+            outputs.push_back(std::move(output));
+        }
+    }
+    results.clear();
+}
+
+void AudioTranscoder::getPending(std::vector<Pending>& pending) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& [streamKey, state] : streams) {
+        if (state->unpolledJobs > 0) {
+            pending.push_back({ state->pid, state->polledPts });
+        }
+    }
+}
+
+uint64_t AudioTranscoder::getLag(uint32_t streamKey) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = streams.find(streamKey);
+    if (it == streams.end()) {
+        return 0;
+    }
+
+    // A timestamp going backwards restarts the stream, which is not lag
+    const StreamState& state = *it->second;
+    if (state.submittedDts <= state.transcodedDts) {
+        return 0;
+    }
+    uint64_t queued = state.submittedDts - state.transcodedDts;
+
+    // Input read faster than real time is ahead of the clock however much of it is queued
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - state.clockStart);
+    uint64_t expected = static_cast<uint64_t>(elapsed.count()) * 9 / 100;
+    uint64_t transcoded = state.transcodedDts > state.clockStartDts ? state.transcodedDts - state.clockStartDts : 0;
+    if (expected <= transcoded) {
+        return 0;
+    }
+    return std::min(expected - transcoded, queued);
+}
+
+void AudioTranscoder::restart(uint32_t streamKey) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = streams.find(streamKey);
+    if (it != streams.end()) {
+        it->second->restart = true;
+    }
+}
+
+void AudioTranscoder::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return pendingJobs == 0; });
+}
+
+void AudioTranscoder::worker() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        workAvailable.wait(lock, [this]() { return stopping || readyStreams.size() > 0; });
+        if (readyStreams.size() == 0) {
+            return;
+        }
+
+        uint32_t streamKey = readyStreams.front();
+        readyStreams.pop_front();
+
+        StreamState& state = *streams[streamKey];
+        Job job = std::move(state.queue.front());
+        state.queue.pop_front();
+
+        lock.unlock();
+        std::vector<AacFrame> frames;
+        process(streamKey, state, job, frames);
+        lock.lock();
+
+        state.transcodedDts = job.endDts;
+        // Also handed out without frames, so that poll() sees the segment is done
+        results.push_back({ streamKey, job.target, std::move(frames) });
+
+        // Other streams queued meanwhile go first
+        if (state.queue.size() > 0) {
+            readyStreams.push_back(streamKey);
+            workAvailable.notify_one();
+        }
+        else {
+            state.scheduled = false;
+        }
+
+        --pendingJobs;
+        if (pendingJobs == 0) {
+            idle.notify_all();
+        }
+        jobDone.notify_all();
+    }
+}
+
+void AudioTranscoder::process(uint32_t streamKey, StreamState& state, Job& job, std::vector<AacFrame>& frames) {
+    try {
+        if (job.restart) {
+            // The encoder is closed before the buffer is cleared, so that what it holds is dropped and not flushed
+            state.decoder.reset();
+            state.encoder.close();
+            state.pcm.clear();
+        }
+
+        // The render layout is fixed when the decoder is created
+        if (!state.decoder || state.layout != job.quality.layout) {
+            fprintf(stderr, "[MPEG-H] Rendering service index %u stream %u to CICP layout %d\n", streamKey >> 16, streamKey & 0xFFFF, job.quality.layout);
+            state.decoder = std::make_unique<MpeghDecoder>(job.quality.layout);
+            state.layout = job.quality.layout;
+        }
+        state.encoder.setAfterburner(job.quality.afterburner ? 1 : 0);
+
+        state.decoder->feed(job.packets, job.timescale, state.pcm);
+        state.encoder.encode(state.pcm, frames);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "[Audio] Transcoding failed for service index %u stream %u: %s\n", streamKey >> 16, streamKey & 0xFFFF, e.what());
+        state.decoder.reset();
+        state.pcm.clear();
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <unordered_map>
+#include "streamPacket.h"
+#include "aacEncoder.h"
+#include "pcmBuffer.h"
+
+class MpeghDecoder;
+
+// Runs MPEG-H decoding and AAC encoding on a pool of worker threads.
+// Segments of one stream are processed in order by one worker at a time,
+// so each stream's decoder and encoder state is never shared between threads.
+class AudioTranscoder {
+public:
+    // Where the encoded frames of a segment go once they are ready
+    struct Target {
+        uint32_t serviceIdx{ 0 };
+        uint16_t pcrOnlyPid{ 0 };
+        uint16_t pid{ 0 };
+    };
+
+    // How much work goes into a segment
+    struct Quality {
+        int32_t layout{ 6 };
+        bool afterburner{ true };
+    };
+
+    struct Output {
+        uint32_t streamKey{ 0 };
+        Target target;
+        std::vector<AacFrame> frames;
+    };
+
+    // A stream with segments that are not polled yet, and the PTS its next frames start from
+    struct Pending {
+        uint16_t pid{ 0 };
+        uint64_t pts{ 0 };
+    };
+
+    AudioTranscoder(uint32_t threadCount);
+    ~AudioTranscoder();
+
+    AudioTranscoder(const AudioTranscoder&) = delete;
+    AudioTranscoder& operator=(const AudioTranscoder&) = delete;
+
+    // Media time a stream may have queued before submit() waits, in 90 kHz units; 0 queues one segment at a time
+    void setMaxQueuedDuration(uint64_t duration);
+
+    // Blocks while the stream already has more than the maximum queued
+    void submit(uint32_t streamKey, const Quality& quality, uint32_t timescale, const std::vector<StreamPacket>& packets, const Target& target);
+
+    // How far the transcoding of a stream has fallen behind real time, in 90 kHz units: the time since
+    // the stream last went idle less the media time transcoded since then, and at most what is queued
+    uint64_t getLag(uint32_t streamKey);
+
+    // Drops the decoder and encoder state of a stream before its next segment, so that nothing held
+    // from before a break, such as a stretch passed through, is stamped onto the segments after it
+    void restart(uint32_t streamKey);
+
+    // Moves out the frames encoded so far, in submission order for each stream
+    void poll(std::vector<Output>& outputs);
+
+    void getPending(std::vector<Pending>& pending);
+
+    // Blocks until every submitted segment has been transcoded
+    void wait();
+
+private:
+    struct Job {
+        Quality quality;
+        uint32_t timescale;
+        uint64_t endDts;
+        std::vector<StreamPacket> packets;
+        Target target;
+        bool restart;
+    };
+
+    struct StreamState {
+        ~StreamState();
+
+        std::unique_ptr<MpeghDecoder> decoder;
+        int32_t layout{ 0 };
+        PcmBuffer pcm;
+        AacEncoder encoder;
+        std::deque<Job> queue;
+        bool scheduled{ false };
+        uint64_t submittedDts{ 0 };
+        uint64_t transcodedDts{ 0 };
+        bool hasDts{ false };
+        // The wall clock and the DTS of the segment the stream started working on after being idle
+        std::chrono::steady_clock::time_point clockStart;
+        uint64_t clockStartDts{ 0 };
+        bool restart{ false };
+        // Segments submitted and not polled yet
+        size_t unpolledJobs{ 0 };
+        uint16_t pid{ 0 };
+        uint64_t polledPts{ 0 };
+    };
+
+    void worker();
+    void process(uint32_t streamKey, StreamState& state, Job& job, std::vector<AacFrame>& frames);
+
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable idle;
+    std::condition_variable jobDone;
+    std::unordered_map<uint32_t, std::unique_ptr<StreamState>> streams;
+    std::deque<uint32_t> readyStreams;
+    std::vector<Output> results;
+    size_t pendingJobs{ 0 };
+    uint64_t maxQueuedDuration{ 0 };
+    bool stopping{ false };
+    std::vector<std::thread> workers;
+
+};
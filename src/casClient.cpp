@@ -0,0 +1,174 @@
+#include "casClient.h"
+#include <regex>
+#include <tuple>
+#include <sstream>
+#include <chrono>
+#include "httplib.h"
+#include "config.h"
+
+namespace {
+
+std::vector<uint8_t> hexstr_to_bytes(const std::string& hex) {
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        std::string byte_str = hex.substr(i, 2);
+        uint8_t byte = static_cast<uint8_t>(std::stoul(byte_str, nullptr, 16));
+        bytes.push_back(byte);
+    }
+    return bytes;
+}
+
+std::array<uint8_t, 16> toArray16(const std::vector<uint8_t>& vec) {
+    if (vec.size() != 16) {
+        throw std::runtime_error("vector size must be 16");
+    }
+
+    std::array<uint8_t, 16> arr;
+    std::copy(vec.begin(), vec.end(), arr.begin());
+    return arr;
+}
+
+std::optional<std::tuple<std::string, std::string, std::string>> splitUrl(const std::string& fullUrl) {
+    std::regex urlRegex(R"((https?)://([^/]+)(/.*))");
+    std::smatch match;
+    if (std::regex_match(fullUrl, match, urlRegex)) {
+        std::string scheme = match[1];
+        std::string host = match[2];
+        std::string path = match[3];
+        return std::make_tuple(scheme, host, path);
+    }
+    else {
+        return std::nullopt;
+    }
+}
+
+}
+
+namespace atsc3 {
+
+CasClient& CasClient::instance() {
+    static CasClient client;
+    return client;
+}
+
+CasClient::~CasClient() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv.notify_all();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+CasClient::Result CasClient::fetch(const CasKey& kid, std::vector<uint8_t> ecm) {
+    Request request;
+    request.kid = kid;
+    request.ecm = std::move(ecm);
+    Result result = request.promise.get_future().share();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!worker.joinable()) {
+            worker = std::thread(&CasClient::workerLoop, this);
+        }
+        requests.push_back(std::move(request));
+    }
+    cv.notify_one();
+
+    return result;
+}
+
+void CasClient::workerLoop() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stop || requests.size() > 0; });
+            if (stop) {
+                return;
+            }
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        std::optional<CasKey> key;
+        for (uint32_t attempt = 0; attempt <= config.casRetries; attempt++) {
+            if (attempt > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100 * attempt));
+            }
+
+            key = post(request);
+            if (key) {
+                break;
+            }
+        }
+
+        if (!key) {
+            fprintf(stderr, "[CAS] Unable to acquire the key after %u attempt(s)\n", config.casRetries + 1);
+        }
+        request.promise.set_value(key);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++completedCount;
+        }
+        completedCv.notify_all();
+    }
+}
+
+uint64_t CasClient::getCompletedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completedCount;
+}
+
+uint64_t CasClient::waitForCompletion(uint64_t completedCount, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    completedCv.wait_for(lock, timeout, [&] { return stop || this->completedCount != completedCount; });
+    return this->completedCount;
+}
+
+std::optional<CasKey> CasClient::post(const Request& request) {
+    auto result = splitUrl(config.casServerUrl);
+    if (!result) {
+        return std::nullopt;
+    }
+
+    auto [scheme, host, path] = *result;
+
+    httplib::Client cli(scheme + "://" + host);
+    cli.set_connection_timeout(std::chrono::milliseconds(config.casTimeoutMs));
+    cli.set_read_timeout(std::chrono::milliseconds(config.casTimeoutMs));
+    cli.set_write_timeout(std::chrono::milliseconds(config.casTimeoutMs));
+
+    std::vector<uint8_t> data;
+    data.insert(data.end(), request.kid.begin(), request.kid.end());
+    data.insert(data.end(), request.ecm.begin(), request.ecm.end());
+
+    std::string body(data.begin(), data.end());
+    auto res = cli.Post(path, body, "application/octet-stream");
+    if (!res || res->status != 200) {
+        return std::nullopt;
+    }
+
+    try {
+        std::istringstream iss(res.value().body);
+        std::string line1, line2;
+        std::getline(iss, line1);
+        std::getline(iss, line2);
+
+        CasKey kid = toArray16(hexstr_to_bytes(line1));
+        CasKey key = toArray16(hexstr_to_bytes(line2));
+        if (kid != request.kid) {
+            return std::nullopt;
+        }
+        return key;
+    }
+    catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <string>
+#include <deque>
+#include <future>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+namespace atsc3 {
+
+using CasKey = std::array<uint8_t, 16>;
+
+// Posts ECMs to the CAS server from a background thread so that the demux
+// thread never blocks on the network.
+class CasClient {
+public:
+    using Result = std::shared_future<std::optional<CasKey>>;
+
+    static CasClient& instance();
+
+    ~CasClient();
+
+    CasClient(const CasClient&) = delete;
+    CasClient& operator=(const CasClient&) = delete;
+
+    // The result holds std::nullopt when every attempt failed
+    Result fetch(const CasKey& kid, std::vector<uint8_t> ecm);
+
+    // Counts the requests that have got their result, failed ones included
+    uint64_t getCompletedCount();
+    // Waits until more requests than the given count have got their result, or the timeout passes,
+    // and returns the count from then
+    uint64_t waitForCompletion(uint64_t completedCount, std::chrono::milliseconds timeout);
+
+private:
+    CasClient() = default;
+
+    struct Request {
+        CasKey kid;
+        std::vector<uint8_t> ecm;
+        std::promise<std::optional<CasKey>> promise;
+    };
+
+    void workerLoop();
+    std::optional<CasKey> post(const Request& request);
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable completedCv;
+    std::deque<Request> requests;
+    uint64_t completedCount{ 0 };
+    bool stop{ false };
+};
+
+}
@@ -1,3 +1,3 @@
-#include "config.h"
-
+#include "config.h"
+
 Config config = Config{};
\ No newline at end of file
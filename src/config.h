@@ -1,10 +1,55 @@
-#pragma once
-#include <string>
-
-class Config {
-public:
-    std::string casServerUrl{};
-
-};
-
+#pragma once
+#include <string>
+#include <cstdint>
+#include <map>
+
+class Config {
+public:
+    std::string casServerUrl{};
+    uint32_t decryptThreads{ 1 };
+    uint32_t casTimeoutMs{ 3000 };
+    uint32_t casRetries{ 2 };
+    std::string keyCacheFile{};
+    uint32_t pcrOffsetMs{ 3000 };
+    uint32_t pcrIntervalMs{ 40 };
+    // Repetition of PAT and PMT, and of SDT and NIT
+    uint32_t psiIntervalMs{ 100 };
+    uint32_t siIntervalMs{ 2000 };
+    // How long PES are held back to be put in DTS order across PIDs
+    uint32_t interleaveWindowMs{ 2000 };
+    uint32_t outputBlockSizeKb{ 2048 };
+    bool outputDirect{ false };
+    uint32_t outputPreallocateMb{ 0 };
+    uint32_t rotateIntervalSec{ 0 };
+    uint32_t rotateSizeMb{ 0 };
+    bool splitServices{ false };
+    // Live TS over HTTP; a port of 0 leaves the server off
+    std::string httpHost{ "0.0.0.0" };
+    uint32_t httpPort{ 0 };
+    uint32_t httpClientBufferKb{ 4096 };
+    // MPTS sent as UDP or RTP; a port of 0 leaves it off
+    std::string udpHost{};
+    uint32_t udpPort{ 0 };
+    bool udpRtp{ false };
+    uint32_t udpTtl{ 1 };
+    bool mpeghPassthrough{ false };
+    bool mpeghUiManager{ false };
+    // CICP layout the MPEG-H decoder renders to, per service ID or for all services
+    static constexpr int32_t mpeghLayoutAuto = 0;
+    int32_t mpeghLayout{ 6 };
+    std::map<uint32_t, int32_t> mpeghServiceLayouts;
+    // 0 picks one less than the number of hardware threads
+    uint32_t audioThreads{ 0 };
+    // How far transcoded audio may fall behind real time before its quality is lowered; 0 never lowers it
+    uint32_t audioLagBudgetMs{ 0 };
+    // AAC frames per PES packet and the time one PES may span; 0 lifts either limit
+    uint32_t audioPesFrames{ 1 };
+    uint32_t audioPesDurationMs{ 0 };
+
+    bool isDecryptionEnabled() const {
+        return casServerUrl != "" || keyCacheFile != "";
+    }
+
+};
+
 extern Config config;
\ No newline at end of file
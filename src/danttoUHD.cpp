@@ -1,130 +1,387 @@
-﻿#include <iostream>
-#include <fstream>
-#include <string>
-#include <vector>
-#include <list>
-#include <iomanip>
-#include <sstream>
-#include "stream.h"
-#include "demuxer.h"
-#include "muxer.h"
-#include "streamPacket.h"
-#include "httplib.h"
-#include "config.h"
-
-atsc3::Demuxer demuxer;
-Muxer muxer;
-
-int main(int argc, char* argv[]) {
-    std::string inputPath, outputPath;
-    std::mutex mutex;
-
-    for (int i = 1; i < argc; ++i) {
-        std::string arg(argv[i]);
-
-        if (arg.find("--casServerUrl=") == 0) {
-            config.casServerUrl = arg.substr(std::string("--casServerUrl=").length());
-        }
-
-        if (inputPath == "") {
-            inputPath = arg;
-        }
-        else if (outputPath == "") {
-            outputPath = arg;
-        }
-    }
-
-    if (inputPath == "" || outputPath == "") {
-        std::cerr << "danttoUHD.exe <input> <output.ts>" << std::endl;
-        std::cerr << "options:" << std::endl;
-        std::cerr << "\t--casServerUrl=<url>" << std::endl;
-        return 1;
-    }
-
-    if (inputPath == outputPath) {
-        std::cerr << "Input and output paths cannot be the same." << std::endl;
-        return 1;
-    }
-
-    std::unique_ptr<std::istream> inputStream;
-    std::unique_ptr<std::ifstream> inputFs;
-    inputFs = std::make_unique<std::ifstream>(inputPath, std::ios::binary);
-    if (!inputFs->is_open()) {
-        std::cerr << "Unable to open input file: " << inputPath << std::endl;
-        return 1;
-    }
-    inputStream = std::move(inputFs);
-
-    std::unique_ptr<std::ofstream> outputFs;
-    outputFs = std::make_unique<std::ofstream>(outputPath, std::ios::binary);
-    if (!outputFs->is_open()) {
-        std::cerr << "Unable to open output file: " << inputPath << std::endl;
-        return 1;
-    }
-
-    std::vector<uint8_t> inputBuffer;
-    constexpr size_t chunkSize = 1024 * 1024;
-
-    uint64_t lastTime = 0;
-
-    std::map<uint64_t, std::vector<uint8_t>> tsBuffer;
-    muxer.setOutputCallback([&](const uint8_t* data, size_t size, uint64_t time) {
-        if (time == 0) {
-            time = lastTime + 1;
-            lastTime = time;
-        }
-
-        auto it = tsBuffer.find(time);
-        if (it == tsBuffer.end()) {
-            tsBuffer[time] = std::vector<uint8_t>(data, data + size);
-        }
-        else {
-            it->second.insert(it->second.end(), data, data + size);
-        }
-
-        if (tsBuffer.size() > 100) {
-            for (auto it = tsBuffer.begin(); it != tsBuffer.end(); ) {
-                if (tsBuffer.size() < 100) {
-                    break;
-                }
-                if (outputFs->is_open()) {
-                    outputFs->write(reinterpret_cast<const char*>(it->second.data()), it->second.size());
-                }
-                it = tsBuffer.erase(it);
-            }
-        }
-
-        if (lastTime < time) {
-            lastTime = time;
-        }
-    });
-    demuxer.setHandler(&muxer);
-
-
-    while (true) {
-        if (inputStream->eof()) {
-            break;
-        }
-
-        size_t oldSize = inputBuffer.size();
-        inputBuffer.resize(oldSize + chunkSize);
-        inputStream->read(reinterpret_cast<char*>(inputBuffer.data() + oldSize), chunkSize);
-        inputBuffer.resize(oldSize + inputStream->gcount());
-
-        demuxer.demux(inputBuffer);
-        inputBuffer.clear();
-    }
-
-    // flush remaining data
-    for (auto it = tsBuffer.begin(); it != tsBuffer.end(); ) {
-        if (tsBuffer.size() < 100) {
-            break;
-        }
-        if (outputFs->is_open()) {
-            outputFs->write(reinterpret_cast<const char*>(it->second.data()), it->second.size());
-        }
-        it = tsBuffer.erase(it);
-    }
-
-    outputFs->close();
+﻿#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <optional>
+#include <algorithm>
+#include "stream.h"
+#include "demuxer.h"
+#include "muxer.h"
+#include "streamPacket.h"
+#include "httplib.h"
+#include "config.h"
+#include "keyStore.h"
+#include "tsFileWriter.h"
+#include "tsHttpServer.h"
+#include "tsUdpSender.h"
+
+atsc3::Demuxer demuxer;
+Muxer muxer;
+
+int main(int argc, char* argv[]) {
+    std::string inputPath, outputPath;
+    std::mutex mutex;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+
+        if (arg.find("--casServerUrl=") == 0) {
+            config.casServerUrl = arg.substr(std::string("--casServerUrl=").length());
+            continue;
+        }
+        if (arg.find("--decryptThreads=") == 0) {
+            config.decryptThreads = std::stoul(arg.substr(std::string("--decryptThreads=").length()));
+            continue;
+        }
+        if (arg.find("--casTimeout=") == 0) {
+            config.casTimeoutMs = std::stoul(arg.substr(std::string("--casTimeout=").length()));
+            continue;
+        }
+        if (arg.find("--casRetries=") == 0) {
+            config.casRetries = std::stoul(arg.substr(std::string("--casRetries=").length()));
+            continue;
+        }
+        if (arg.find("--keyCacheFile=") == 0) {
+            config.keyCacheFile = arg.substr(std::string("--keyCacheFile=").length());
+            continue;
+        }
+        if (arg.find("--pcrOffset=") == 0) {
+            config.pcrOffsetMs = std::stoul(arg.substr(std::string("--pcrOffset=").length()));
+            continue;
+        }
+        if (arg.find("--pcrInterval=") == 0) {
+            config.pcrIntervalMs = std::stoul(arg.substr(std::string("--pcrInterval=").length()));
+            continue;
+        }
+        if (arg.find("--psiInterval=") == 0) {
+            config.psiIntervalMs = std::stoul(arg.substr(std::string("--psiInterval=").length()));
+            continue;
+        }
+        if (arg.find("--siInterval=") == 0) {
+            config.siIntervalMs = std::stoul(arg.substr(std::string("--siInterval=").length()));
+            continue;
+        }
+        if (arg.find("--interleaveWindow=") == 0) {
+            config.interleaveWindowMs = std::stoul(arg.substr(std::string("--interleaveWindow=").length()));
+            continue;
+        }
+        if (arg.find("--outputBlockSize=") == 0) {
+            config.outputBlockSizeKb = std::stoul(arg.substr(std::string("--outputBlockSize=").length()));
+            continue;
+        }
+        if (arg == "--outputDirect") {
+            config.outputDirect = true;
+            continue;
+        }
+        if (arg.find("--outputPreallocate=") == 0) {
+            config.outputPreallocateMb = std::stoul(arg.substr(std::string("--outputPreallocate=").length()));
+            continue;
+        }
+        if (arg.find("--rotateInterval=") == 0) {
+            config.rotateIntervalSec = std::stoul(arg.substr(std::string("--rotateInterval=").length()));
+            continue;
+        }
+        if (arg.find("--httpServer=") == 0) {
+            // [<host>:]<port>
+            std::string value = arg.substr(std::string("--httpServer=").length());
+            size_t separator = value.rfind(':');
+            if (separator != std::string::npos) {
+                config.httpHost = value.substr(0, separator);
+                value = value.substr(separator + 1);
+            }
+            config.httpPort = std::stoul(value);
+            continue;
+        }
+        if (arg.find("--httpClientBuffer=") == 0) {
+            config.httpClientBufferKb = std::stoul(arg.substr(std::string("--httpClientBuffer=").length()));
+            continue;
+        }
+        if (arg.find("--udpOutput=") == 0) {
+            // <host>:<port>
+            std::string value = arg.substr(std::string("--udpOutput=").length());
+            size_t separator = value.rfind(':');
+            if (separator == std::string::npos) {
+                std::cerr << "Invalid UDP output: " << value << std::endl;
+                return 1;
+            }
+            config.udpHost = value.substr(0, separator);
+            config.udpPort = std::stoul(value.substr(separator + 1));
+            // [<IPv6 address>]:<port>
+            if (config.udpHost.size() >= 2 && config.udpHost.front() == '[' && config.udpHost.back() == ']') {
+                config.udpHost = config.udpHost.substr(1, config.udpHost.size() - 2);
+            }
+            continue;
+        }
+        if (arg == "--udpRtp") {
+            config.udpRtp = true;
+            continue;
+        }
+        if (arg.find("--udpTtl=") == 0) {
+            config.udpTtl = std::stoul(arg.substr(std::string("--udpTtl=").length()));
+            continue;
+        }
+        if (arg == "--splitServices") {
+            config.splitServices = true;
+            continue;
+        }
+        if (arg.find("--rotateSize=") == 0) {
+            config.rotateSizeMb = std::stoul(arg.substr(std::string("--rotateSize=").length()));
+            continue;
+        }
+        if (arg == "--mpeghPassthrough") {
+            config.mpeghPassthrough = true;
+            continue;
+        }
+        if (arg == "--mpeghUiManager") {
+            config.mpeghUiManager = true;
+            continue;
+        }
+        if (arg.find("--mpeghLayout=") == 0) {
+            // [<serviceId>:]<cicp|auto>
+            std::string value = arg.substr(std::string("--mpeghLayout=").length());
+            std::optional<uint32_t> serviceId;
+            size_t separator = value.find(':');
+            if (separator != std::string::npos) {
+                serviceId = std::stoul(value.substr(0, separator));
+                value = value.substr(separator + 1);
+            }
+
+            int32_t layout = value == "auto" ? Config::mpeghLayoutAuto : std::stoi(value);
+            // AAC can carry up to 5.1, which is CICP 6
+            if (layout < 0 || layout > 6) {
+                std::cerr << "Unsupported MPEG-H layout: " << value << std::endl;
+                return 1;
+            }
+
+            if (serviceId) {
+                config.mpeghServiceLayouts[*serviceId] = layout;
+            }
+            else {
+                config.mpeghLayout = layout;
+            }
+            continue;
+        }
+        if (arg.find("--audioThreads=") == 0) {
+            config.audioThreads = std::stoul(arg.substr(std::string("--audioThreads=").length()));
+            continue;
+        }
+        if (arg.find("--audioLagBudget=") == 0) {
+            config.audioLagBudgetMs = std::stoul(arg.substr(std::string("--audioLagBudget=").length()));
+            continue;
+        }
+        if (arg.find("--audioPesFrames=") == 0) {
+            config.audioPesFrames = std::stoul(arg.substr(std::string("--audioPesFrames=").length()));
+            continue;
+        }
+        if (arg.find("--audioPesDuration=") == 0) {
+            config.audioPesDurationMs = std::stoul(arg.substr(std::string("--audioPesDuration=").length()));
+            continue;
+        }
+
+        if (inputPath == "") {
+            inputPath = arg;
+        }
+        else if (outputPath == "") {
+            outputPath = arg;
+        }
+    }
+
+    // The output file may be left out when the TS is only served over HTTP or sent over UDP
+    bool networkOutput = config.httpPort != 0 || config.udpPort != 0;
+    if (inputPath == "" || (outputPath == "" && (!networkOutput || config.splitServices))) {
+        std::cerr << "danttoUHD.exe <input> [<output.ts>]" << std::endl;
+        std::cerr << "options:" << std::endl;
+        std::cerr << "\t--casServerUrl=<url>" << std::endl;
+        std::cerr << "\t--decryptThreads=<n>" << std::endl;
+        std::cerr << "\t--casTimeout=<ms>" << std::endl;
+        std::cerr << "\t--casRetries=<n>" << std::endl;
+        std::cerr << "\t--keyCacheFile=<path>" << std::endl;
+        std::cerr << "\t--pcrOffset=<ms>" << std::endl;
+        std::cerr << "\t--pcrInterval=<ms>" << std::endl;
+        std::cerr << "\t--psiInterval=<ms>" << std::endl;
+        std::cerr << "\t--siInterval=<ms>" << std::endl;
+        std::cerr << "\t--interleaveWindow=<ms>" << std::endl;
+        std::cerr << "\t--outputBlockSize=<KiB>" << std::endl;
+        std::cerr << "\t--outputDirect" << std::endl;
+        std::cerr << "\t--outputPreallocate=<MiB>" << std::endl;
+        std::cerr << "\t--rotateInterval=<sec>" << std::endl;
+        std::cerr << "\t--rotateSize=<MiB>" << std::endl;
+        std::cerr << "\t--splitServices" << std::endl;
+        std::cerr << "\t--httpServer=[<host>:]<port>" << std::endl;
+        std::cerr << "\t--httpClientBuffer=<KiB>" << std::endl;
+        std::cerr << "\t--udpOutput=<host>:<port>" << std::endl;
+        std::cerr << "\t--udpRtp" << std::endl;
+        std::cerr << "\t--udpTtl=<n>" << std::endl;
+        std::cerr << "\t--mpeghPassthrough" << std::endl;
+        std::cerr << "\t--mpeghUiManager" << std::endl;
+        std::cerr << "\t--mpeghLayout=[<serviceId>:]<cicp|auto>" << std::endl;
+        std::cerr << "\t--audioThreads=<n>" << std::endl;
+        std::cerr << "\t--audioLagBudget=<ms>" << std::endl;
+        std::cerr << "\t--audioPesFrames=<n>" << std::endl;
+        std::cerr << "\t--audioPesDuration=<ms>" << std::endl;
+        return 1;
+    }
+
+    if (inputPath == outputPath) {
+        std::cerr << "Input and output paths cannot be the same." << std::endl;
+        return 1;
+    }
+
+    if (config.audioLagBudgetMs != 0 && config.audioLagBudgetMs >= config.interleaveWindowMs) {
+        // Video is held back for as long as the audio lags, so it piles up past the window
+        std::cerr << "--audioLagBudget must be shorter than --interleaveWindow." << std::endl;
+        return 1;
+    }
+
+    if (config.keyCacheFile != "" && !atsc3::KeyStore::instance().openCacheFile(config.keyCacheFile)) {
+        std::cerr << "Unable to open key cache file: " << config.keyCacheFile << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<std::istream> inputStream;
+    std::unique_ptr<std::ifstream> inputFs;
+    inputFs = std::make_unique<std::ifstream>(inputPath, std::ios::binary);
+    if (!inputFs->is_open()) {
+        std::cerr << "Unable to open input file: " << inputPath << std::endl;
+        return 1;
+    }
+    inputStream = std::move(inputFs);
+
+    TsFileWriter::Options writerOptions;
+    writerOptions.blockSize = static_cast<size_t>(config.outputBlockSizeKb) * 1024;
+    writerOptions.direct = config.outputDirect;
+    writerOptions.preallocateSize = static_cast<uint64_t>(config.outputPreallocateMb) * 1024 * 1024;
+
+    RotatingTsFileWriter outputWriter;
+    // One SPTS file per service, named after the output path and the service ID, opened with the first data
+    std::unordered_map<uint32_t, std::unique_ptr<RotatingTsFileWriter>> mapServiceWriter;
+    bool serviceWriteFailed = false;
+
+    uint64_t rotateInterval = static_cast<uint64_t>(config.rotateIntervalSec) * 90000;
+    uint64_t rotateSize = static_cast<uint64_t>(config.rotateSizeMb) * 1024 * 1024;
+
+    TsHttpServer httpServer;
+    bool httpEnabled = config.httpPort != 0;
+    if (httpEnabled) {
+        TsHttpServer::Options httpOptions;
+        httpOptions.maxQueuedChunks = std::max<size_t>(static_cast<size_t>(config.httpClientBufferKb) * 1024 / httpOptions.chunkSize, 1);
+        if (!httpServer.start(config.httpHost, config.httpPort, httpOptions)) {
+            std::cerr << "Unable to start HTTP server on " << config.httpHost << ":" << config.httpPort << std::endl;
+            return 1;
+        }
+    }
+
+    TsUdpSender udpSender;
+    bool udpEnabled = config.udpPort != 0;
+    if (udpEnabled) {
+        TsUdpSender::Options udpOptions;
+        udpOptions.rtp = config.udpRtp;
+        udpOptions.ttl = static_cast<int>(config.udpTtl);
+        if (!udpSender.open(config.udpHost, static_cast<uint16_t>(config.udpPort), udpOptions)) {
+            std::cerr << "Unable to open UDP output: " << config.udpHost << ":" << config.udpPort << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.splitServices || httpEnabled) {
+        muxer.setServiceOutputCallback([&](uint32_t serviceId, const uint8_t* data, size_t size, uint64_t time) {
+            if (httpEnabled) {
+                httpServer.write(serviceId, data, size);
+            }
+            if (!config.splitServices) {
+                return;
+            }
+
+            auto it = mapServiceWriter.find(serviceId);
+            if (it == mapServiceWriter.end()) {
+                std::string path = appendToFileName(outputPath, "_" + std::to_string(serviceId));
+                auto writer = std::make_unique<RotatingTsFileWriter>();
+                if (!writer->open(path, writerOptions, rotateInterval, rotateSize)) {
+                    std::cerr << "Unable to open output file: " << path << std::endl;
+                    serviceWriteFailed = true;
+                }
+                it = mapServiceWriter.emplace(serviceId, std::move(writer)).first;
+            }
+            it->second->write(data, size);
+        });
+    }
+    if (httpEnabled) {
+        muxer.setServiceListCallback([&](const std::vector<uint32_t>& serviceIds) {
+            httpServer.setServices(serviceIds);
+        });
+    }
+    if (config.splitServices) {
+        muxer.setServiceSplitCallback([&](uint32_t serviceId, uint64_t dts) {
+            auto it = mapServiceWriter.find(serviceId);
+            return it != mapServiceWriter.end() && it->second->rotateIfDue(dts);
+        });
+    }
+
+    bool writeMpts = !config.splitServices && outputPath != "";
+    if (writeMpts) {
+        if (!outputWriter.open(outputPath, writerOptions, rotateInterval, rotateSize)) {
+            std::cerr << "Unable to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+
+        muxer.setSplitCallback([&](uint64_t dts) {
+            return outputWriter.rotateIfDue(dts);
+        });
+    }
+    if (writeMpts || httpEnabled || udpEnabled) {
+        muxer.setOutputCallback([&](const uint8_t* data, size_t size, uint64_t time) {
+            if (writeMpts) {
+                outputWriter.write(data, size);
+            }
+            if (httpEnabled) {
+                httpServer.write(TsHttpServer::mptsStream, data, size);
+            }
+            if (udpEnabled) {
+                udpSender.write(data, size);
+            }
+        });
+    }
+
+    std::vector<uint8_t> inputBuffer;
+    constexpr size_t chunkSize = 1024 * 1024;
+
+    demuxer.setHandler(&muxer);
+
+
+    while (true) {
+        if (inputStream->eof()) {
+            break;
+        }
+
+        size_t oldSize = inputBuffer.size();
+        inputBuffer.resize(oldSize + chunkSize);
+        inputStream->read(reinterpret_cast<char*>(inputBuffer.data() + oldSize), chunkSize);
+        inputBuffer.resize(oldSize + inputStream->gcount());
+
+        demuxer.demux(inputBuffer);
+        inputBuffer.clear();
+    }
+
+    // wait for segments that are still waiting for their key, waking up as CAS requests complete
+    uint64_t casCompleted = atsc3::CasClient::instance().getCompletedCount();
+    while (demuxer.poll() == atsc3::DemuxStatus::WattingForEcm) {
+        casCompleted = atsc3::CasClient::instance().waitForCompletion(casCompleted, std::chrono::seconds(1));
+    }
+    muxer.flush();
+    httpServer.stop();
+    udpSender.close();
+
+    for (auto& [serviceId, writer] : mapServiceWriter) {
+        if (!writer->close()) {
+            serviceWriteFailed = true;
+        }
+    }
+    if (!outputWriter.close() || serviceWriteFailed) {
+        std::cerr << "Unable to write output file: " << outputPath << std::endl;
+        return 1;
+    }
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
-#pragma once
-#include <vector>
-#include <cstdint>
-#include <optional>
-#include <string>
-
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string>
+
 std::optional<std::string> gzipInflate(const std::vector<uint8_t>& input);
\ No newline at end of file
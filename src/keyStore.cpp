@@ -0,0 +1,190 @@
+#include "keyStore.h"
+#include <sstream>
+#include "config.h"
+
+namespace {
+
+bool parseHex16(const std::string& hex, std::array<uint8_t, 16>& output) {
+    if (hex.size() != 32) {
+        return false;
+    }
+
+    for (size_t i = 0; i < 16; i++) {
+        uint8_t byte = 0;
+        for (size_t j = 0; j < 2; j++) {
+            char c = hex[i * 2 + j];
+            byte <<= 4;
+            if (c >= '0' && c <= '9') {
+                byte |= c - '0';
+            }
+            else if (c >= 'a' && c <= 'f') {
+                byte |= c - 'a' + 10;
+            }
+            else if (c >= 'A' && c <= 'F') {
+                byte |= c - 'A' + 10;
+            }
+            else {
+                return false;
+            }
+        }
+        output[i] = byte;
+    }
+    return true;
+}
+
+void writeHex16(std::ostream& os, const std::array<uint8_t, 16>& input) {
+    static const char digits[] = "0123456789abcdef";
+    for (uint8_t byte : input) {
+        os.put(digits[byte >> 4]);
+        os.put(digits[byte & 0xF]);
+    }
+}
+
+}
+
+namespace atsc3 {
+
+KeyStore& KeyStore::instance() {
+    static KeyStore store;
+    return store;
+}
+
+KeyStatus KeyStore::acquire(const CasKey& kid, const std::vector<uint8_t>& ecm, CasKey& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Clock::time_point now = Clock::now();
+    expire(now);
+
+    auto it = entries.find(kid);
+    if (it == entries.end() && config.casServerUrl == "") {
+        return KeyStatus::Failed;
+    }
+
+    if (it == entries.end()) {
+        Entry entry;
+        entry.status = KeyStatus::Pending;
+        entry.result = CasClient::instance().fetch(kid, ecm);
+        entry.lastUsed = now;
+        entries.emplace(kid, std::move(entry));
+        return KeyStatus::Pending;
+    }
+
+    Entry& entry = it->second;
+    if (entry.status == KeyStatus::Pending) {
+        if (entry.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return KeyStatus::Pending;
+        }
+
+        std::optional<CasKey> result = entry.result.get();
+        entry.result = {};
+        entry.lastUsed = now;
+        if (result) {
+            entry.status = KeyStatus::Ready;
+            entry.key = *result;
+            persist(kid, entry);
+        }
+        else {
+            entry.status = KeyStatus::Failed;
+        }
+    }
+
+    if (entry.status == KeyStatus::Failed) {
+        if (now - entry.lastUsed < kFailedHoldoff) {
+            return KeyStatus::Failed;
+        }
+
+        if (config.casServerUrl == "") {
+            entry.lastUsed = now;
+            return KeyStatus::Failed;
+        }
+
+        entry.status = KeyStatus::Pending;
+        entry.result = CasClient::instance().fetch(kid, ecm);
+        entry.lastUsed = now;
+        return KeyStatus::Pending;
+    }
+
+    entry.lastUsed = now;
+    key = entry.key;
+    return KeyStatus::Ready;
+}
+
+void KeyStore::expire(Clock::time_point now) {
+    if (now - lastExpire < std::chrono::seconds(10)) {
+        return;
+    }
+    lastExpire = now;
+
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (it->second.status != KeyStatus::Pending && !it->second.persistent && now - it->second.lastUsed > kKeyExpiry) {
+            it = entries.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+bool KeyStore::openCacheFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Each line holds "<kid> <key>" in hex. A line cut short by a crash is skipped.
+    size_t loaded = 0;
+    std::ifstream input(path);
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream iss(line);
+        std::string kidHex, keyHex;
+        if (!(iss >> kidHex >> keyHex)) {
+            continue;
+        }
+
+        CasKey kid, key;
+        if (!parseHex16(kidHex, kid) || !parseHex16(keyHex, key)) {
+            continue;
+        }
+
+        Entry& entry = entries[kid];
+        entry.status = KeyStatus::Ready;
+        entry.key = key;
+        entry.lastUsed = Clock::now();
+        entry.persistent = true;
+        ++loaded;
+    }
+    input.close();
+
+    // A line cut short has no newline, and the next key would be appended to it
+    bool endsWithNewline = true;
+    std::ifstream tail(path, std::ios::binary | std::ios::ate);
+    if (tail.is_open() && tail.tellg() > 0) {
+        tail.seekg(-1, std::ios::end);
+        endsWithNewline = tail.get() == '\n';
+    }
+    tail.close();
+
+    cacheFile.open(path, std::ios::app);
+    if (!cacheFile.is_open()) {
+        return false;
+    }
+    if (!endsWithNewline) {
+        cacheFile.put('\n');
+        cacheFile.flush();
+    }
+
+    fprintf(stderr, "[CAS] Loaded %zu key(s) from %s\n", loaded, path.c_str());
+    return true;
+}
+
+void KeyStore::persist(const CasKey& kid, Entry& entry) {
+    if (!cacheFile.is_open()) {
+        return;
+    }
+
+    writeHex16(cacheFile, kid);
+    cacheFile.put(' ');
+    writeHex16(cacheFile, entry.key);
+    cacheFile.put('\n');
+    cacheFile.flush();
+    entry.persistent = true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+#include "casClient.h"
+
+namespace atsc3 {
+
+struct CasKeyHash {
+    size_t operator()(const CasKey& kid) const {
+        uint64_t a, b;
+        memcpy(&a, kid.data(), sizeof(a));
+        memcpy(&b, kid.data() + sizeof(a), sizeof(b));
+        return static_cast<size_t>(a ^ (b * 0x9E3779B97F4A7C15ULL));
+    }
+};
+
+enum class KeyStatus {
+    Ready,
+    Pending,
+    Failed,
+};
+
+// Process-wide KID -> key store shared by every service and stream.
+// Concurrent requests for the same KID are coalesced into a single CAS request.
+class KeyStore {
+public:
+    static KeyStore& instance();
+
+    KeyStore(const KeyStore&) = delete;
+    KeyStore& operator=(const KeyStore&) = delete;
+
+    // Returns Ready and fills key when the key is known. Otherwise a CAS request is started
+    // with the given ECM, or joined if one is already in flight for this KID.
+    KeyStatus acquire(const CasKey& kid, const std::vector<uint8_t>& ecm, CasKey& key);
+
+    // Loads the keys stored in an append-only cache file and appends every newly acquired key to it
+    bool openCacheFile(const std::string& path);
+
+private:
+    KeyStore() = default;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Keys of past crypto periods are no longer looked up once the stream has rotated
+    // to a new KID, so they are evicted after being idle for this long.
+    static constexpr std::chrono::minutes kKeyExpiry{ 10 };
+    // A failed KID is not requested again until this much time has passed
+    static constexpr std::chrono::seconds kFailedHoldoff{ 5 };
+
+    struct Entry {
+        KeyStatus status{ KeyStatus::Pending };
+        CasKey key{};
+        CasClient::Result result;
+        Clock::time_point lastUsed;
+        // Keys stored in the cache file are never expired
+        bool persistent{ false };
+    };
+
+    void expire(Clock::time_point now);
+    void persist(const CasKey& kid, Entry& entry);
+
+    std::mutex mutex;
+    std::unordered_map<CasKey, Entry, CasKeyHash> entries;
+    Clock::time_point lastExpire;
+    std::ofstream cacheFile;
+};
+
+}
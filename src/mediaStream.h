@@ -1,36 +1,51 @@
-#pragma once
-#include <cstdint>
-#include "mp4Processor.h"
-
-namespace atsc3 {
-
-enum class StreamType {
-    VIDEO,
-    AUDIO,
-    SUBTITLE,
-    UNKNOWN,
-};
-enum class CodecType {
-    MPEG1,
-    MPEG2,
-    MPEGH3D,
-    HEVC,
-    AAC,
-    AAC_LATM,
-    UNKNOWN,
-};
-
-class MediaStream {
-public:;
-    virtual ~MediaStream() = default;
-    virtual StreamType getStreamType() const { return StreamType::UNKNOWN; }
-    virtual CodecType getCodecType() const { return CodecType::UNKNOWN; }
-
-public:
-    uint16_t idx{0};
-    uint16_t packetId{0};
-    struct MP4CodecConfig mp4CodecConfig;
-
-};
-
+#pragma once
+#include <cstdint>
+#include "mp4Processor.h"
+
+namespace atsc3 {
+
+enum class StreamType {
+    VIDEO,
+    AUDIO,
+    SUBTITLE,
+    UNKNOWN,
+};
+enum class CodecType {
+    MPEG1,
+    MPEG2,
+    MPEGH3D,
+    HEVC,
+    AAC,
+    AAC_LATM,
+    UNKNOWN,
+};
+
+class MediaStream {
+public:;
+    virtual ~MediaStream() = default;
+    virtual StreamType getStreamType() const { return StreamType::UNKNOWN; }
+    virtual CodecType getCodecType() const {
+        switch (mp4CodecConfig.sampleEntryType) {
+        case SampleEntryType::hev1:
+        case SampleEntryType::hvc1:
+            return CodecType::HEVC;
+        case SampleEntryType::mp4a:
+            return CodecType::AAC;
+        case SampleEntryType::mha1:
+        case SampleEntryType::mha2:
+        case SampleEntryType::mhm1:
+        case SampleEntryType::mhm2:
+            return CodecType::MPEGH3D;
+        default:
+            return CodecType::UNKNOWN;
+        }
+    }
+
+public:
+    uint16_t idx{0};
+    uint16_t packetId{0};
+    struct MP4CodecConfig mp4CodecConfig;
+
+};
+
 }
\ No newline at end of file
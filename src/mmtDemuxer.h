@@ -1,59 +1,89 @@
-#pragma once
-#include <cstdint>
-#include <functional>
-#include "stream.h"
-#include "mmt.h"
-#include "mmtAssembler.h"
-#include <memory>
-#include "mediaTransportDemuxer.h"
-#include "mediaStream.h"
-#include "mmtDescriptor.h"
-
-namespace atsc3 {
-
- class MmtStream : public MediaStream {
- public:
-    virtual StreamType getStreamType() const override {
-        if (assetType == MmtAssetType::mp4a) {
-            return StreamType::AUDIO;
-        }
-        else if (assetType == MmtAssetType::mhm1) {
-            return StreamType::AUDIO;
-        }
-        else if (assetType == MmtAssetType::hev1) {
-            return StreamType::VIDEO;
-        }
-        else if (assetType == MmtAssetType::stpp) {
-            return StreamType::SUBTITLE;
-        }
-        return StreamType::UNKNOWN;
-    }
-
-    std::optional<uint64_t> getTimestamp();
-
- public:
-     std::vector<uint8_t> mfuBuffer;
-     std::vector<uint8_t> movieFragmentMetadataBuffer;
-     std::vector<uint8_t> mpuMetadataBuffer;
-     std::vector<MmtMpuTimestampDescriptor::Entry> mpuTimestamps;
-     uint32_t assetType{0};
-     uint32_t mdatLength{0};
-     uint32_t currentMpuSequenceNumber{0};
-
-};
-
-class MmtDemuxer : public MediaTransportDemuxer {
-public:
-    MmtDemuxer(Service& service) : MediaTransportDemuxer(service) {}
-    virtual bool processPacket(Common::ReadStream& stream);
-
-private:
-    bool processMpu(uint16_t packetId, const MmtMpu& mpu, const std::vector<uint8_t>& data);
-    bool processSignalingMessage(uint16_t packetId, const std::vector<uint8_t>& data);
-
-
-    std::unordered_map<uint16_t, MmtStream> mapStream;
-    MmtAssembler mfuAssembler;
-};
-
+#pragma once
+#include <cstdint>
+#include <functional>
+#include "stream.h"
+#include "mmt.h"
+#include "mmtAssembler.h"
+#include <memory>
+#include <map>
+#include "mediaTransportDemuxer.h"
+#include "mediaStream.h"
+#include "mmtDescriptor.h"
+
+namespace atsc3 {
+
+ class MmtStream : public MediaStream {
+ public:
+    virtual StreamType getStreamType() const override {
+        if (assetType == MmtAssetType::mp4a) {
+            return StreamType::AUDIO;
+        }
+        else if (assetType == MmtAssetType::mhm1) {
+            return StreamType::AUDIO;
+        }
+        else if (assetType == MmtAssetType::hev1) {
+            return StreamType::VIDEO;
+        }
+        else if (assetType == MmtAssetType::stpp) {
+            return StreamType::SUBTITLE;
+        }
+        return StreamType::UNKNOWN;
+    }
+
+    virtual CodecType getCodecType() const override {
+        CodecType codecType = MediaStream::getCodecType();
+        if (codecType != CodecType::UNKNOWN) {
+            return codecType;
+        }
+
+        // Until the MPU metadata has been parsed, the asset type is all there is
+        if (assetType == MmtAssetType::mp4a) {
+            return CodecType::AAC;
+        }
+        else if (assetType == MmtAssetType::mhm1) {
+            return CodecType::MPEGH3D;
+        }
+        else if (assetType == MmtAssetType::hev1) {
+            return CodecType::HEVC;
+        }
+        return CodecType::UNKNOWN;
+    }
+
+    std::optional<uint64_t> getTimestamp();
+    void addMpuTimestamp(const MmtMpuTimestampDescriptor::Entry& entry);
+
+    // Number of MPU timestamps kept per stream; the oldest sequence numbers are evicted first
+    static constexpr size_t kMaxMpuTimestamps = 256;
+
+ public:
+     std::vector<uint8_t> mfuBuffer;
+     std::vector<uint8_t> movieFragmentMetadataBuffer;
+     std::vector<uint8_t> mpuMetadataBuffer;
+     std::map<uint32_t, uint64_t> mpuTimestamps;
+     uint32_t assetType{0};
+     uint32_t mdatLength{0};
+     uint32_t currentMpuSequenceNumber{0};
+
+};
+
+class MmtDemuxer : public MediaTransportDemuxer {
+public:
+    MmtDemuxer(Service& service) : MediaTransportDemuxer(service) {}
+    virtual bool processPacket(Common::ReadStream& stream);
+
+private:
+    bool processMpu(uint16_t packetId, const MmtMpu& mpu, const std::vector<uint8_t>& data);
+    bool processSignalingMessage(uint16_t packetId, const std::vector<uint8_t>& data);
+    void notifyStreamTable();
+
+    struct MptCache {
+        bool valid{ false };
+        std::vector<uint8_t> data;
+    };
+
+    std::unordered_map<uint16_t, MmtStream> mapStream;
+    std::unordered_map<uint16_t, MptCache> mapMptCache;
+    MmtAssembler mfuAssembler;
+};
+
 }
\ No newline at end of file
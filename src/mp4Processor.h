@@ -1,56 +1,108 @@
-#pragma once
-#include <map>
-#include <array>
-#include <vector>
-#include <cstdint>
-#include <list>
-#include "streamPacket.h"
-
-class AP4_Atom;
-class AP4_TrunAtom;
-class AP4_ContainerAtom;
-class AP4_TfdtAtom;
-class AP4_TfhdAtom;
-class AlcStream;
-
-namespace atsc3 {
-
-struct MP4CodecConfig {
-    std::vector<uint8_t> prefixNalUnits;
-    uint32_t timescale{ 0 };
-    uint8_t nalUnitLengthSize{ 0 };
-};
-
-class MP4ConfigParser {
-public:
-    static bool parse(const std::vector<uint8_t>& input, struct MP4CodecConfig& config);
-};
-
-class MP4Processor {
-public:
-    bool process(const std::vector<uint8_t>& data, std::vector<StreamPacket>& packets);
-
-private:
-    bool ProcessMdat(AP4_Atom* trun);
-    bool ProcessMoof(AP4_ContainerAtom* trun);
-    bool ProcessPssh(AP4_Atom* trun);
-    void ProcessSenc(AP4_Atom* trun);
-    void ProcessTrun(AP4_TrunAtom* trun);
-    void ProcessTfdt(AP4_TfdtAtom* tfdt);
-    void ProcessTfhd(AP4_TfhdAtom* tfhd);
-    void clear();
-
-    std::array<uint8_t, 16> currentKid;
-    std::vector<uint32_t> vecSampleSize;
-    std::vector<uint32_t> vecSampleCompositionTimeOffset;
-    std::list<std::pair<std::array<uint8_t, 16>, std::array<uint8_t, 16>>> keyCache;
-    std::vector<std::array<uint8_t, 16>> vecIv;
-    std::vector<uint8_t>* g_output;
-    AP4_TrunAtom* g_trun;
-    uint64_t baseDts{ 0 };
-    uint32_t baseSampleDuration{ 0 };
-    std::vector<struct StreamPacket> packets;
-
-};
-
+#pragma once
+#include <map>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include "streamPacket.h"
+#include "sampleDecryptor.h"
+#include "keyStore.h"
+
+class AP4_Atom;
+class AP4_TrunAtom;
+class AP4_ContainerAtom;
+class AP4_TfdtAtom;
+class AP4_TfhdAtom;
+class AlcStream;
+
+namespace atsc3 {
+
+constexpr uint32_t makeSampleEntryType(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    return (a << 24) | (b << 16) | (c << 8) | d;
+}
+
+namespace SampleEntryType {
+
+constexpr uint32_t hev1 = makeSampleEntryType('h', 'e', 'v', '1');
+constexpr uint32_t hvc1 = makeSampleEntryType('h', 'v', 'c', '1');
+constexpr uint32_t mp4a = makeSampleEntryType('m', 'p', '4', 'a');
+constexpr uint32_t mha1 = makeSampleEntryType('m', 'h', 'a', '1');
+constexpr uint32_t mha2 = makeSampleEntryType('m', 'h', 'a', '2');
+constexpr uint32_t mhm1 = makeSampleEntryType('m', 'h', 'm', '1');
+constexpr uint32_t mhm2 = makeSampleEntryType('m', 'h', 'm', '2');
+
+}
+
+struct MP4CodecConfig {
+    std::vector<uint8_t> prefixNalUnits;
+    uint32_t timescale{ 0 };
+    uint8_t nalUnitLengthSize{ 0 };
+    // Four character code of the first sample entry (the original one for encrypted tracks),
+    // 0 until an init segment was seen
+    uint32_t sampleEntryType{ 0 };
+    // AudioSpecificConfig of mp4a sample entries
+    std::vector<uint8_t> decoderSpecificInfo;
+    // From the mhaC box of MPEG-H sample entries
+    uint8_t mpeghProfileLevelIndication{ 0 };
+    uint8_t mpeghReferenceChannelLayout{ 0 };
+};
+
+class MP4ConfigParser {
+public:
+    static bool parse(const std::vector<uint8_t>& input, struct MP4CodecConfig& config);
+};
+
+enum class MP4ProcessResult {
+    Ok,
+    Error,
+    WaitingForKey,
+};
+
+// A media segment parsed into its samples, which stay encrypted until decrypt() has the key
+struct MP4Segment {
+    std::vector<StreamPacket> packets;
+    std::vector<std::array<uint8_t, 16>> vecIv;
+    // From the pssh box; segments without one use the key of the one before
+    bool hasPssh{ false };
+    CasKey kid{};
+    std::vector<uint8_t> ecm;
+};
+
+class MP4Processor {
+public:
+    MP4ProcessResult parse(const std::vector<uint8_t>& data, MP4Segment& segment);
+    // Acquires the key of a parsed segment and decrypts its samples in place. A segment that gets
+    // WaitingForKey is passed in again later, without being parsed again.
+    MP4ProcessResult decrypt(MP4Segment& segment);
+
+private:
+    bool ProcessMdat(AP4_Atom* trun);
+    void ProcessMoof(AP4_ContainerAtom* trun);
+    void ProcessPssh(AP4_Atom* trun);
+    void ProcessSenc(AP4_Atom* trun);
+    void ProcessTrun(AP4_TrunAtom* trun);
+    void ProcessTfdt(AP4_TfdtAtom* tfdt);
+    void ProcessTfhd(AP4_TfhdAtom* tfhd);
+    void clear();
+
+    std::array<uint8_t, 16> currentKid;
+    std::array<uint8_t, 16> currentKey;
+    bool hasCurrentKey{ false };
+    std::vector<uint32_t> vecSampleSize;
+    std::vector<uint32_t> vecSampleCompositionTimeOffset;
+    std::vector<std::optional<bool>> vecSampleKeyframe;
+    std::optional<uint32_t> defaultSampleFlags;
+    std::vector<std::array<uint8_t, 16>> vecIv;
+    bool hasPssh{ false };
+    CasKey psshKid{};
+    std::vector<uint8_t> psshEcm;
+    std::vector<uint8_t>* g_output;
+    AP4_TrunAtom* g_trun;
+    uint64_t baseDts{ 0 };
+    uint32_t baseSampleDuration{ 0 };
+    std::vector<struct StreamPacket> packets;
+
+};
+
 }
\ No newline at end of file
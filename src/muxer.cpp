@@ -1,427 +1,1022 @@
-#include "muxer.h"
-#include <map>
-#include <regex>
-#include <filesystem>
-#include <vector>
-#include "pesPacket.h"
-#include "streamPacket.h"
-#include "mpeghDecoder.h"
-#include "stream.h"
-#include "service.h"
-#include "rescale.h"
-#include "mp4Processor.h"
-#include <Ap4HevcParser.h>
-
-namespace {
-
-std::pair<bool, bool> hevcProcess(const atsc3::MP4CodecConfig& mp4Config, const std::vector<uint8_t>& input, std::vector<uint8_t>& output) {
-    bool have_access_unit_delimiter = false;
-    bool have_param_sets = false;
-    bool hasRandomAccessIndicator = false;
-
-    Common::ReadStream s(input);
-    while (s.leftBytes()) {
-        if (s.leftBytes() < mp4Config.nalUnitLengthSize) {
-            return { false, false };
-        }
-        uint32_t nalUnitSize = 0;
-        if (mp4Config.nalUnitLengthSize == 1) {
-            nalUnitSize = s.get8U();
-        }
-        else if (mp4Config.nalUnitLengthSize == 2) {
-            nalUnitSize = s.getBe16U();
-        }
-        else if (mp4Config.nalUnitLengthSize == 3) {
-            nalUnitSize = s.getBe16U() << 8;
-            nalUnitSize |= s.get8U();
-        }
-        else if (mp4Config.nalUnitLengthSize == 4) {
-            nalUnitSize = s.getBe32U();
-        }
-        else {
-            return { false, false };
-        }
-
-        if (s.leftBytes() < nalUnitSize) {
-            return { false, false };
-        }
-
-        unsigned int nal_unit_type = (s.peek8U() >> 1) & 0x3F;
-        if (nal_unit_type == AP4_HEVC_NALU_TYPE_AUD_NUT) {
-            have_access_unit_delimiter = true;
-        }
-        if (nal_unit_type == AP4_HEVC_NALU_TYPE_VPS_NUT ||
-            nal_unit_type == AP4_HEVC_NALU_TYPE_SPS_NUT ||
-            nal_unit_type == AP4_HEVC_NALU_TYPE_PPS_NUT) {
-            have_param_sets = true;
-            break;
-        }
-
-        s.skip(nalUnitSize);
-    }
-
-    if (!have_access_unit_delimiter) {
-        output.insert(output.end(), {0, 0, 0, 1, AP4_HEVC_NALU_TYPE_AUD_NUT << 1 , 1, 0x40});
-    }
-
-    bool prefix_added = false;
-    s.seek(0);
-    while (s.leftBytes()) {
-        uint32_t nalUnitSize = 0;
-        if (mp4Config.nalUnitLengthSize == 1) {
-            nalUnitSize = s.get8U();
-        }
-        else if (mp4Config.nalUnitLengthSize == 2) {
-            nalUnitSize = s.getBe16U();
-        }
-        else if (mp4Config.nalUnitLengthSize == 3) {
-            nalUnitSize = s.getBe16U() << 8;
-            nalUnitSize |= s.get8U();
-        }
-        else if (mp4Config.nalUnitLengthSize == 4) {
-            nalUnitSize = s.getBe32U();
-        }
-        else {
-            return { false, false };
-        }
-
-        if (s.leftBytes() < nalUnitSize) {
-            return { false, false };
-        }
-
-        if (!prefix_added) {
-            output.insert(output.end(), mp4Config.prefixNalUnits.begin(), mp4Config.prefixNalUnits.end());
-            prefix_added = true;
-        }
-
-        std::vector<uint8_t> buffer;
-        buffer.resize(nalUnitSize);
-        s.read(buffer.data(), nalUnitSize);
-
-
-        unsigned int nal_unit_type = (buffer[0] >> 1) & 0x3F;
-        if (nal_unit_type == AP4_HEVC_NALU_TYPE_IDR_W_RADL ||
-            nal_unit_type == AP4_HEVC_NALU_TYPE_IDR_N_LP ||
-            nal_unit_type == AP4_HEVC_NALU_TYPE_CRA_NUT ||
-            nal_unit_type == AP4_HEVC_NALU_TYPE_BLA_W_LP ||
-            nal_unit_type == AP4_HEVC_NALU_TYPE_BLA_W_RADL ||
-            nal_unit_type == AP4_HEVC_NALU_TYPE_BLA_N_LP
-            ) {
-            hasRandomAccessIndicator = true;
-        }
-
-        output.insert(output.end(), { 0, 0, 1 });
-        output.insert(output.end(), buffer.begin(), buffer.end());
-    }
-
-    return { have_access_unit_delimiter, hasRandomAccessIndicator };
-}
-
-uint16_t calcPesPid(const atsc3::Service& service, uint32_t streamIdx) {
-    return service.getPmtPid() + 1 + streamIdx;
-}
-
-}
-
-enum class Mpeg2StreamType : uint8_t {
-    VIDEO_MPEG1 = 0x01,
-    VIDEO_MPEG2 = 0x02,
-    AUDIO_MPEG1 = 0x03,
-    AUDIO_MPEG2 = 0x04,
-    PRIVATE_SECTION = 0x05,
-    PRIVATE_DATA = 0x06,
-    ISO_IEC_13818_6_TYPE_D = 0x0d,
-    AUDIO_AAC = 0x0f,
-    AUDIO_AAC_LATM = 0x11,
-    VIDEO_MPEG4 = 0x10,
-    METADATA = 0x15,
-    VIDEO_H264 = 0x1b,
-    VIDEO_HEVC = 0x24,
-    VIDEO_AC3 = 0x81,
-};
-
-void Muxer::setOutputCallback(OutputCallback cb) {
-    outputCallback = std::move(cb);
-}
-
-void Muxer::onSlt(const atsc3::ServiceManager& sm) {
-    if (!ready) {
-        return;
-    }
-
-    {
-        std::vector<uint8_t> tsBuffer;
-        ts::PAT pat(0, true, sm.bsid, sm.bsid);
-        for (const auto& service : sm.services) {
-            if (!service->isMediaService()) {
-                continue;
-            }
-            pat.pmts[service->serviceId] = service->getPmtPid();
-        }
-
-        ts::BinaryTable table;
-        pat.serialize(duck, table);
-
-        ts::OneShotPacketizer packetizer(duck, ts::PID_PAT);
-
-        for (size_t i = 0; i < table.sectionCount(); i++) {
-            const ts::SectionPtr& section = table.sectionAt(i);
-            packetizer.addSection(section);
-
-            ts::TSPacketVector packets;
-            packetizer.getPackets(packets);
-            for (auto& packet : packets) {
-                packet.setCC(mapCC[ts::PID_PAT] & 0xF);
-                mapCC[ts::PID_PAT]++;
-
-                tsBuffer.insert(tsBuffer.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-            }
-        }
-        outputCallback(tsBuffer.data(), tsBuffer.size(), 0);
-    }
-
-    {
-        std::vector<uint8_t> tsBuffer;
-        ts::SDT sdt(true, 0, true, sm.bsid, sm.bsid);
-        for (const auto& service : sm.services) {
-            if (!service->isMediaService()) {
-                continue;
-            }
-
-            ts::SDT::ServiceEntry tsService(&sdt);
-            ts::ServiceDescriptor tsDescriptor;
-            tsDescriptor.service_name = ts::UString::FromUTF8(service->shortServiceName);
-            tsDescriptor.service_type = 1;
-            tsService.descs.add(duck, tsDescriptor);
-            sdt.services[service->serviceId] = tsService;
-        }
-
-        ts::BinaryTable table;
-        sdt.serialize(duck, table);
-
-        ts::OneShotPacketizer packetizer(duck, ts::PID_SDT);
-
-        for (size_t i = 0; i < table.sectionCount(); i++) {
-            const ts::SectionPtr& section = table.sectionAt(i);
-            packetizer.addSection(section);
-
-            ts::TSPacketVector packets;
-            packetizer.getPackets(packets);
-            for (auto& packet : packets) {
-                packet.setCC(mapCC[ts::PID_SDT] & 0xF);
-                mapCC[ts::PID_SDT]++;
-
-                tsBuffer.insert(tsBuffer.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-            }
-        }
-        outputCallback(tsBuffer.data(), tsBuffer.size(), 0);
-    }
-
-    {
-        std::vector<uint8_t> tsBuffer;
-        ts::NIT nit(true, 0, true, sm.bsid);
-        ts::NetworkNameDescriptor tsDescriptor;
-        tsDescriptor.name = ts::UString::FromUTF8("danttoUHD (https://github.com/nekohkr/danttoUHD)");
-        nit.descs.add(duck, tsDescriptor);
-
-        ts::BinaryTable table;
-        nit.serialize(duck, table);
-
-        ts::OneShotPacketizer packetizer(duck, ts::PID_NIT);
-
-        for (size_t i = 0; i < table.sectionCount(); i++) {
-            const ts::SectionPtr& section = table.sectionAt(i);
-            packetizer.addSection(section);
-
-            ts::TSPacketVector packets;
-            packetizer.getPackets(packets);
-            for (auto& packet : packets) {
-                packet.setCC(mapCC[ts::PID_NIT] & 0xF);
-                mapCC[ts::PID_NIT]++;
-
-                tsBuffer.insert(tsBuffer.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-            }
-        }
-        outputCallback(tsBuffer.data(), tsBuffer.size(), 0);
-    }
-}
-
-void Muxer::onPmt(const atsc3::Service& service, std::vector<std::reference_wrapper<atsc3::MediaStream>> streams) {
-    if (!ready) {
-        return;
-    }
-
-    if (!service.isMediaService()) {
-        return;
-    }
-
-    uint16_t pcrPid = 0x1fff;
-    for (const auto& stream : streams) {
-        if (stream.get().getStreamType() == atsc3::StreamType::VIDEO) {
-            pcrPid = calcPesPid(service, stream.get().idx);
-            break;
-        }
-    }
-
-    uint16_t pid = service.getPmtPid();
-    ts::PMT tsPmt(0, true, pcrPid);
-    tsPmt.service_id = service.serviceId;
-
-    for (const auto& stream : streams) {
-        if (stream.get().getStreamType() == atsc3::StreamType::VIDEO) {
-            ts::PMT::Stream tsStream(&tsPmt, static_cast<uint8_t>(Mpeg2StreamType::VIDEO_HEVC));
-            ts::RegistrationDescriptor descriptor;
-            descriptor.format_identifier = 0x48455643;
-            tsStream.descs.add(duck, descriptor);
-
-            tsPmt.streams[calcPesPid(service, stream.get().idx)] = tsStream;
-        }
-        if (stream.get().getStreamType() == atsc3::StreamType::AUDIO) {
-            ts::PMT::Stream tsStream(&tsPmt, static_cast<uint8_t>(Mpeg2StreamType::AUDIO_AAC));
-            tsPmt.streams[calcPesPid(service, stream.get().idx)] = tsStream;
-        }
-        if (stream.get().getStreamType() == atsc3::StreamType::SUBTITLE) {
-            ts::PMT::Stream tsStream(&tsPmt, static_cast<uint8_t>(Mpeg2StreamType::ISO_IEC_13818_6_TYPE_D));
-            tsPmt.streams[calcPesPid(service, stream.get().idx)] = tsStream;
-        }
-    }
-
-    ts::BinaryTable table;
-    tsPmt.serialize(duck, table);
-
-    ts::OneShotPacketizer packetizer(duck, pid);
-
-    std::vector<uint8_t> tsBuffer;
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        packetizer.addSection(section);
-
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[pid] & 0xF);
-            ++mapCC[pid];
-
-            tsBuffer.insert(tsBuffer.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        }
-    }
-
-    outputCallback(tsBuffer.data(), tsBuffer.size(), 0);
-}
-
-void Muxer::onStreamData(const atsc3::Service& service, const atsc3::MediaStream& stream, const std::vector<StreamPacket>& packets) {
-    std::vector<uint8_t> tsBuffer;
-    uint16_t pid = calcPesPid(service, stream.idx);
-    AVRational r = { 1, static_cast<int>(stream.mp4CodecConfig.timescale) };
-    AVRational ts = { 1, 90000 };
-    uint64_t baseDts = av_rescale_q(packets[0].dts, r, ts);
-
-    if (stream.getStreamType() == atsc3::StreamType::VIDEO) {
-        for (const auto& packet : packets) {
-            uint64_t dts = av_rescale_q(packet.dts, r, ts);
-            uint64_t pts = av_rescale_q(packet.pts, r, ts);
-
-            std::vector<uint8_t> pesOutput;
-            std::vector<uint8_t> processed;
-
-            auto hevcResult = hevcProcess(stream.mp4CodecConfig, packet.data, processed);
-
-            PESPacket pes;
-            pes.setPts(pts);
-            pes.setDts(dts);
-            pes.setStreamId(STREAM_ID_VIDEO_STREAM_0);
-            if (hevcResult.first) {
-                pes.setDataAlignmentIndicator(true);
-            }
-            pes.setPayload(&processed);
-            pes.pack(pesOutput);
-
-            size_t payloadLength = pesOutput.size();
-            int i = 0;
-            while (payloadLength > 0) {
-                ts::TSPacket packet;
-                packet.init(pid, mapCC[pid] & 0xF);
-                ++mapCC[pid];
-                if (i == 0) {
-                    packet.setPUSI();
-                    packet.setPCR((dts-9000*3) * 300, true);
-                    if (hevcResult.second) {
-                        packet.setRandomAccessIndicator(true);
-                    }
-                }
-
-                const size_t chunkSize = std::min(payloadLength, static_cast<size_t>(188 - packet.getHeaderSize()));
-                packet.setPayloadSize(chunkSize);
-                memcpy(packet.b + packet.getHeaderSize(), pesOutput.data() + (pesOutput.size() - payloadLength), chunkSize);
-                payloadLength -= chunkSize;
-
-                tsBuffer.insert(tsBuffer.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-                ++i;
-            }
-
-            outputCallback(tsBuffer.data(), tsBuffer.size(), 0);
-            tsBuffer.clear();
-            ready = true;
-        }
-    }
-    else if (stream.getStreamType() == atsc3::StreamType::AUDIO) {
-        uint64_t sampleDuration = packets[1].dts - packets[0].dts;
-        uint64_t duration = sampleDuration * packets.size();
-
-        uint32_t streamKey = service.idx << 16 | stream.idx;
-        if (mapMpeghDecoder.find(streamKey) == mapMpeghDecoder.end()) {
-            mapMpeghDecoder[streamKey] = new MpeghDecoder();
-        }
-
-        MpeghDecoderResult decodeResult = mapMpeghDecoder[streamKey]->feed(packets, sampleDuration, stream.mp4CodecConfig.timescale);
-
-        std::vector<std::vector<uint8_t>> aac;
-        mapAACEncoder[streamKey].encode(decodeResult.wav, aac);
-        if (aac.size() == 0) {
-            return;
-        }
-
-        uint64_t durationPerFrame = duration / aac.size();
-        int frameCounter = 0;
-        for (const auto& item : aac) {
-            PESPacket pes;
-            std::vector<uint8_t> pesOutput;
-            AVRational r = { 1, static_cast<int>(stream.mp4CodecConfig.timescale) };
-            AVRational ts = { 1, 90000 };
-            uint64_t dts = av_rescale_q(packets[0].dts + frameCounter * durationPerFrame, r, ts);
-            ++frameCounter;
-
-            pes.setPts(dts);
-            pes.setDts(dts);
-            pes.setStreamId(STREAM_ID_AUDIO_STREAM_0);
-            pes.setPayload(&item);
-            pes.pack(pesOutput);
-
-            size_t payloadLength = pesOutput.size();
-            int i = 0;
-
-            while (payloadLength > 0) {
-                ts::TSPacket packet;
-                packet.init(pid, mapCC[pid] & 0xF);
-                ++mapCC[pid];
-
-                if (i == 0) {
-                    packet.setPUSI();
-                }
-
-                const size_t chunkSize = std::min(payloadLength, static_cast<size_t>(188 - packet.getHeaderSize()));
-                packet.setPayloadSize(chunkSize);
-                memcpy(packet.b + packet.getHeaderSize(), pesOutput.data() + (pesOutput.size() - payloadLength), chunkSize);
-                payloadLength -= chunkSize;
-
-                tsBuffer.insert(tsBuffer.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-                ++i;
-            }
-
-            outputCallback(tsBuffer.data(), tsBuffer.size(), 0);
-            tsBuffer.clear();
-        }
-    }
-
-
-}
+#include "muxer.h"
+#include <map>
+#include <algorithm>
+#include <regex>
+#include <filesystem>
+#include <vector>
+#include "pesPacket.h"
+#include "streamPacket.h"
+#include "stream.h"
+#include "service.h"
+#include "rescale.h"
+#include "mp4Processor.h"
+#include "config.h"
+#include <Ap4HevcParser.h>
+
+namespace {
+
+template <uint8_t LengthSize>
+inline uint32_t readNalUnitLength(const uint8_t* p) {
+    if constexpr (LengthSize == 1) {
+        return p[0];
+    }
+    else if constexpr (LengthSize == 2) {
+        return (p[0] << 8) | p[1];
+    }
+    else if constexpr (LengthSize == 3) {
+        return (p[0] << 16) | (p[1] << 8) | p[2];
+    }
+    else {
+        return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+}
+
+inline bool isRandomAccessNalUnit(unsigned int nalUnitType) {
+    return nalUnitType == AP4_HEVC_NALU_TYPE_IDR_W_RADL ||
+        nalUnitType == AP4_HEVC_NALU_TYPE_IDR_N_LP ||
+        nalUnitType == AP4_HEVC_NALU_TYPE_CRA_NUT ||
+        nalUnitType == AP4_HEVC_NALU_TYPE_BLA_W_LP ||
+        nalUnitType == AP4_HEVC_NALU_TYPE_BLA_W_RADL ||
+        nalUnitType == AP4_HEVC_NALU_TYPE_BLA_N_LP;
+}
+
+struct HevcSampleInfo {
+    bool hasAccessUnitDelimiter{ false };
+    bool hasParameterSets{ false };
+    bool randomAccess{ false };
+    // Where parameter sets go in the output when they are inserted
+    size_t parameterSetsPos{ 0 };
+};
+
+// Converts one length-prefixed sample to Annex-B without copying it: the output refers to
+// the sample's NAL units and constant start codes. An access unit delimiter is emitted first
+// (the sample's own one if it starts with it).
+// The same pass fills in the info from the NAL unit headers up to the first VCL NAL unit:
+// the access unit delimiter and in-band parameter sets precede it, and all VCL NAL units of
+// an IRAP picture share its type.
+template <uint8_t LengthSize>
+bool hevcConvert(const std::vector<uint8_t>& input, std::vector<PesChunk>& output, HevcSampleInfo& info) {
+    static constexpr uint8_t startCode[] = { 0, 0, 1 };
+    static constexpr uint8_t longStartCode[] = { 0, 0, 0, 1 };
+    static constexpr uint8_t accessUnitDelimiter[] = { 0, 0, 0, 1, AP4_HEVC_NALU_TYPE_AUD_NUT << 1, 1, 0x40 };
+
+    const uint8_t* p = input.data();
+    const uint8_t* end = p + input.size();
+
+    output.clear();
+
+    bool first = true;
+    bool foundVcl = false;
+    while (p < end) {
+        if (static_cast<size_t>(end - p) < LengthSize) {
+            output.clear();
+            return false;
+        }
+
+        uint32_t nalUnitSize = readNalUnitLength<LengthSize>(p);
+        p += LengthSize;
+        if (static_cast<size_t>(end - p) < nalUnitSize) {
+            output.clear();
+            return false;
+        }
+        if (nalUnitSize == 0) {
+            continue;
+        }
+
+        unsigned int nal_unit_type = (p[0] >> 1) & 0x3F;
+        if (!foundVcl) {
+            if (nal_unit_type == AP4_HEVC_NALU_TYPE_AUD_NUT) {
+                info.hasAccessUnitDelimiter = true;
+            }
+            else if (nal_unit_type == AP4_HEVC_NALU_TYPE_VPS_NUT ||
+                nal_unit_type == AP4_HEVC_NALU_TYPE_SPS_NUT ||
+                nal_unit_type == AP4_HEVC_NALU_TYPE_PPS_NUT) {
+                info.hasParameterSets = true;
+            }
+            else if (nal_unit_type < 32) {
+                info.randomAccess = isRandomAccessNalUnit(nal_unit_type);
+                foundVcl = true;
+            }
+        }
+
+        if (first) {
+            first = false;
+
+            if (nal_unit_type == AP4_HEVC_NALU_TYPE_AUD_NUT) {
+                output.push_back({ longStartCode, sizeof(longStartCode) });
+                output.push_back({ p, nalUnitSize });
+                info.parameterSetsPos = output.size();
+                p += nalUnitSize;
+                continue;
+            }
+
+            output.push_back({ accessUnitDelimiter, sizeof(accessUnitDelimiter) });
+            info.parameterSetsPos = output.size();
+        }
+
+        output.push_back({ startCode, sizeof(startCode) });
+        output.push_back({ p, nalUnitSize });
+        p += nalUnitSize;
+    }
+
+    if (first) {
+        output.push_back({ accessUnitDelimiter, sizeof(accessUnitDelimiter) });
+        info.parameterSetsPos = output.size();
+    }
+
+    return true;
+}
+
+template <uint8_t LengthSize>
+bool hevcProcessImpl(const StreamPacket& packet, HevcParameterSetTracker& tracker, std::vector<PesChunk>& output, HevcSampleInfo& info) {
+    if (!hevcConvert<LengthSize>(packet.data, output, info)) {
+        return false;
+    }
+
+    // Sync sample flags from the movie fragment take precedence over the NAL unit type
+    if (packet.keyframe) {
+        info.randomAccess = *packet.keyframe;
+    }
+
+    if (tracker.shouldInsert(info.randomAccess, info.hasParameterSets)) {
+        const std::vector<uint8_t>& parameterSets = tracker.getParameterSets();
+        output.insert(output.begin() + info.parameterSetsPos, PesChunk{ parameterSets.data(), parameterSets.size() });
+    }
+    return true;
+}
+
+bool hevcProcess(const atsc3::MP4CodecConfig& mp4Config, const StreamPacket& packet, HevcParameterSetTracker& tracker, std::vector<PesChunk>& output, HevcSampleInfo& info) {
+    switch (mp4Config.nalUnitLengthSize) {
+    case 1:
+        return hevcProcessImpl<1>(packet, tracker, output, info);
+    case 2:
+        return hevcProcessImpl<2>(packet, tracker, output, info);
+    case 3:
+        return hevcProcessImpl<3>(packet, tracker, output, info);
+    case 4:
+        return hevcProcessImpl<4>(packet, tracker, output, info);
+    default:
+        output.clear();
+        return false;
+    }
+}
+
+// Each service has the 16 PIDs from its PMT PID on, which leaves room for 15 streams
+constexpr uint32_t maxStreamsPerService = 0x0F;
+
+bool hasPesPid(uint32_t streamIdx) {
+    return streamIdx < maxStreamsPerService;
+}
+
+uint16_t calcPesPid(const atsc3::Service& service, uint32_t streamIdx) {
+    return service.getPmtPid() + 1 + streamIdx;
+}
+
+// Services without video carry the PCR on a PID of its own, taken from
+// the range after the PID blocks of all 255 services
+uint16_t calcPcrOnlyPid(const atsc3::Service& service) {
+    return 0x1100 + service.idx;
+}
+
+// Samples of mhm1/mhm2 tracks are MHAS packets, which is what MPEG-H streams carry in TS
+bool isMhasSampleEntry(uint32_t sampleEntryType) {
+    return sampleEntryType == atsc3::SampleEntryType::mhm1 ||
+        sampleEntryType == atsc3::SampleEntryType::mhm2;
+}
+
+uint32_t calcStreamKey(const atsc3::Service& service, const atsc3::MediaStream& stream) {
+    return service.idx << 16 | stream.idx;
+}
+
+bool canPassThroughMpegh(const atsc3::MediaStream& stream) {
+    if (stream.getStreamType() != atsc3::StreamType::AUDIO) {
+        return false;
+    }
+
+    uint32_t sampleEntryType = stream.mp4CodecConfig.sampleEntryType;
+    switch (stream.getCodecType()) {
+    case atsc3::CodecType::MPEGH3D:
+        // mha1/mha2 samples are raw MPEG-H frames rather than MHAS packets
+        return sampleEntryType == 0 || isMhasSampleEntry(sampleEntryType);
+    case atsc3::CodecType::UNKNOWN:
+        // Audio is assumed to be MPEG-H until the init segment tells otherwise
+        return sampleEntryType == 0;
+    default:
+        return false;
+    }
+}
+
+int32_t selectMpeghLayout(const atsc3::Service& service, const atsc3::MediaStream& stream) {
+    int32_t layout = config.mpeghLayout;
+    auto it = config.mpeghServiceLayouts.find(service.serviceId);
+    if (it != config.mpeghServiceLayouts.end()) {
+        layout = it->second;
+    }
+
+    if (layout == Config::mpeghLayoutAuto) {
+        // Follow the reference layout of the stream as far as AAC can carry it
+        uint8_t referenceLayout = stream.mp4CodecConfig.mpeghReferenceChannelLayout;
+        layout = referenceLayout >= 1 && referenceLayout <= 6 ? referenceLayout : defaultCicpSetup;
+    }
+    return layout;
+}
+
+// One step below the given layout: 5.1 and the others go down to stereo, stereo to mono
+int32_t lowerMpeghLayout(int32_t layout) {
+    return layout > 2 ? 2 : 1;
+}
+
+uint64_t calcPcr(uint64_t dts) {
+    uint64_t offset = static_cast<uint64_t>(config.pcrOffsetMs) * 90;
+    return ((dts - offset) & 0x1FFFFFFFF) * 300;
+}
+
+}
+
+enum class Mpeg2StreamType : uint8_t {
+    VIDEO_MPEG1 = 0x01,
+    VIDEO_MPEG2 = 0x02,
+    AUDIO_MPEG1 = 0x03,
+    AUDIO_MPEG2 = 0x04,
+    PRIVATE_SECTION = 0x05,
+    PRIVATE_DATA = 0x06,
+    ISO_IEC_13818_6_TYPE_D = 0x0d,
+    AUDIO_AAC = 0x0f,
+    AUDIO_AAC_LATM = 0x11,
+    VIDEO_MPEG4 = 0x10,
+    METADATA = 0x15,
+    VIDEO_H264 = 0x1b,
+    VIDEO_HEVC = 0x24,
+    AUDIO_MPEGH_3D_MAIN = 0x2d,
+    VIDEO_AC3 = 0x81,
+};
+
+void Muxer::setOutputCallback(OutputCallback cb) {
+    outputCallback = std::move(cb);
+}
+
+void Muxer::setSplitCallback(SplitCallback cb) {
+    splitCallback = std::move(cb);
+}
+
+void Muxer::setServiceOutputCallback(ServiceOutputCallback cb) {
+    serviceOutputCallback = std::move(cb);
+}
+
+void Muxer::setServiceSplitCallback(ServiceSplitCallback cb) {
+    serviceSplitCallback = std::move(cb);
+}
+
+void Muxer::setServiceListCallback(ServiceListCallback cb) {
+    serviceListCallback = std::move(cb);
+}
+
+void Muxer::onSlt(const atsc3::ServiceManager& sm) {
+    {
+        ts::PAT tsPat(0, true, sm.bsid, sm.bsid);
+        std::string signature = std::to_string(sm.bsid);
+        for (const auto& service : sm.services) {
+            if (!service->isMediaService()) {
+                continue;
+            }
+            tsPat.pmts[service->serviceId] = service->getPmtPid();
+            signature += "," + std::to_string(service->serviceId) + ":" + std::to_string(service->getPmtPid());
+        }
+
+        if (pat.hasChanged(signature)) {
+            updatePsiTable(pat, signature, ts::PID_PAT, tsPat);
+        }
+    }
+
+    {
+        ts::SDT tsSdt(true, 0, true, sm.bsid, sm.bsid);
+        std::string signature = std::to_string(sm.bsid);
+        for (const auto& service : sm.services) {
+            if (!service->isMediaService()) {
+                continue;
+            }
+
+            ts::SDT::ServiceEntry tsService(&tsSdt);
+            ts::ServiceDescriptor tsDescriptor;
+            tsDescriptor.service_name = ts::UString::FromUTF8(service->shortServiceName);
+            tsDescriptor.service_type = 1;
+            tsService.descs.add(duck, tsDescriptor);
+            tsSdt.services[service->serviceId] = tsService;
+            signature += "," + std::to_string(service->serviceId) + ":" + service->shortServiceName;
+        }
+
+        if (sdt.hasChanged(signature)) {
+            updatePsiTable(sdt, signature, ts::PID_SDT, tsSdt);
+        }
+    }
+
+    {
+        std::string signature = std::to_string(sm.bsid);
+        if (nit.hasChanged(signature)) {
+            ts::NIT tsNit(true, 0, true, sm.bsid);
+            ts::NetworkNameDescriptor tsDescriptor;
+            tsDescriptor.name = ts::UString::FromUTF8("danttoUHD (https://github.com/nekohkr/danttoUHD)");
+            tsNit.descs.add(duck, tsDescriptor);
+
+            updatePsiTable(nit, signature, ts::PID_NIT, tsNit);
+        }
+    }
+
+    {
+        std::vector<uint32_t> ids;
+        for (const auto& service : sm.services) {
+            if (service->isMediaService()) {
+                ids.push_back(service->serviceId);
+            }
+        }
+        if (ids != serviceIds) {
+            serviceIds = std::move(ids);
+            if (serviceListCallback) {
+                serviceListCallback(serviceIds);
+            }
+        }
+    }
+
+    if (serviceOutputCallback) {
+        for (const auto& service : sm.services) {
+            if (!service->isMediaService()) {
+                continue;
+            }
+
+            ServiceOutput& serviceOutput = mapServiceOutput[service->idx];
+            serviceOutput.serviceId = service->serviceId;
+
+            ts::PAT tsPat(0, true, sm.bsid, sm.bsid);
+            tsPat.pmts[service->serviceId] = service->getPmtPid();
+            std::string signature = std::to_string(sm.bsid) + "," + std::to_string(service->serviceId) + ":" + std::to_string(service->getPmtPid());
+            if (serviceOutput.pat.hasChanged(signature)) {
+                updatePsiTable(serviceOutput.pat, signature, ts::PID_PAT, tsPat);
+            }
+
+            ts::SDT tsSdt(true, 0, true, sm.bsid, sm.bsid);
+            ts::SDT::ServiceEntry tsService(&tsSdt);
+            ts::ServiceDescriptor tsDescriptor;
+            tsDescriptor.service_name = ts::UString::FromUTF8(service->shortServiceName);
+            tsDescriptor.service_type = 1;
+            tsService.descs.add(duck, tsDescriptor);
+            tsSdt.services[service->serviceId] = tsService;
+            signature = std::to_string(sm.bsid) + "," + std::to_string(service->serviceId) + ":" + service->shortServiceName;
+            if (serviceOutput.sdt.hasChanged(signature)) {
+                updatePsiTable(serviceOutput.sdt, signature, ts::PID_SDT, tsSdt);
+            }
+
+            // The NIT is the same for every output
+            copyPsiTable(serviceOutput.nit, nit);
+            auto it = mapPmt.find(service->idx);
+            if (it != mapPmt.end()) {
+                copyPsiTable(serviceOutput.pmt, it->second);
+            }
+        }
+    }
+
+    // Services that left the SLT stop having their PMT sent
+    for (auto it = mapPmt.begin(); it != mapPmt.end(); ) {
+        auto found = std::find_if(sm.services.begin(), sm.services.end(),
+            [&](const auto& service) { return service->idx == it->first && service->isMediaService(); });
+        if (found == sm.services.end()) {
+            if (psiClockServiceIdx == it->first) {
+                psiClockServiceIdx.reset();
+            }
+            mapServiceHasVideo.erase(it->first);
+            mapPmtStreams.erase(it->first);
+            it = mapPmt.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    for (auto it = mapServiceOutput.begin(); it != mapServiceOutput.end(); ) {
+        auto found = std::find_if(sm.services.begin(), sm.services.end(),
+            [&](const auto& service) { return service->idx == it->first && service->isMediaService(); });
+        if (found == sm.services.end()) {
+            it = mapServiceOutput.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    selectPsiClockService();
+}
+
+void Muxer::onPmt(const atsc3::Service& service, std::vector<std::reference_wrapper<atsc3::MediaStream>> streams) {
+    if (!service.isMediaService()) {
+        return;
+    }
+    mapPmtStreams[service.idx] = streams;
+
+    uint16_t pcrPid = calcPcrOnlyPid(service);
+    bool hasVideo = false;
+    for (const auto& stream : streams) {
+        if (stream.get().getStreamType() == atsc3::StreamType::VIDEO && hasPesPid(stream.get().idx)) {
+            pcrPid = calcPesPid(service, stream.get().idx);
+            hasVideo = true;
+            break;
+        }
+    }
+    getPcrScheduler(service.idx).setPid(pcrPid);
+
+    uint16_t pid = service.getPmtPid();
+    ts::PMT tsPmt(0, true, pcrPid);
+    tsPmt.service_id = service.serviceId;
+    std::string signature = std::to_string(service.serviceId) + "," + std::to_string(pcrPid);
+
+    for (const auto& stream : streams) {
+        if (!hasPesPid(stream.get().idx)) {
+            // Keeps the streams that are left out in the signature, so they are reported once
+            signature += ",-" + std::to_string(stream.get().idx);
+            continue;
+        }
+
+        uint16_t streamPid = calcPesPid(service, stream.get().idx);
+        if (stream.get().getStreamType() == atsc3::StreamType::VIDEO) {
+            ts::PMT::Stream tsStream(&tsPmt, static_cast<uint8_t>(Mpeg2StreamType::VIDEO_HEVC));
+            ts::RegistrationDescriptor descriptor;
+            descriptor.format_identifier = 0x48455643;
+            tsStream.descs.add(duck, descriptor);
+
+            tsPmt.streams[streamPid] = tsStream;
+        }
+        if (stream.get().getStreamType() == atsc3::StreamType::AUDIO) {
+            if (isMpeghPassthrough(service, stream.get())) {
+                const atsc3::MP4CodecConfig& mp4Config = stream.get().mp4CodecConfig;
+                ts::PMT::Stream tsStream(&tsPmt, static_cast<uint8_t>(Mpeg2StreamType::AUDIO_MPEGH_3D_MAIN));
+                ts::MPEGH3DAudioDescriptor descriptor;
+                // LC profile level 3 is what ATSC 3.0 uses when there is no mhaC box
+                descriptor.mpegh_3da_profile_level_indication = mp4Config.mpeghProfileLevelIndication ? mp4Config.mpeghProfileLevelIndication : 0x0D;
+                descriptor.reference_channel_layout = mp4Config.mpeghReferenceChannelLayout;
+                tsStream.descs.add(duck, descriptor);
+
+                tsPmt.streams[streamPid] = tsStream;
+                signature += "," + std::to_string(descriptor.mpegh_3da_profile_level_indication) + "/" + std::to_string(descriptor.reference_channel_layout);
+            }
+            else {
+                ts::PMT::Stream tsStream(&tsPmt, static_cast<uint8_t>(Mpeg2StreamType::AUDIO_AAC));
+                tsPmt.streams[streamPid] = tsStream;
+            }
+        }
+        if (stream.get().getStreamType() == atsc3::StreamType::SUBTITLE) {
+            ts::PMT::Stream tsStream(&tsPmt, static_cast<uint8_t>(Mpeg2StreamType::ISO_IEC_13818_6_TYPE_D));
+            tsPmt.streams[streamPid] = tsStream;
+        }
+
+        auto it = tsPmt.streams.find(streamPid);
+        if (it != tsPmt.streams.end()) {
+            signature += "," + std::to_string(streamPid) + ":" + std::to_string(it->second.stream_type);
+        }
+    }
+
+    PsiTable& pmt = mapPmt[service.idx];
+    if (pmt.hasChanged(signature)) {
+        updatePsiTable(pmt, signature, pid, tsPmt);
+
+        for (const auto& stream : streams) {
+            if (!hasPesPid(stream.get().idx)) {
+                fprintf(stderr, "[Muxer] Service %u has no PID left for stream %u, leaving it out\n",
+                    service.serviceId, stream.get().idx);
+            }
+        }
+    }
+
+    mapServiceHasVideo[service.idx] = hasVideo;
+    selectPsiClockService();
+    ready = true;
+
+    // The SPTS sends the same PMT on a schedule of its own
+    auto it = mapServiceOutput.find(service.idx);
+    if (it != mapServiceOutput.end()) {
+        copyPsiTable(it->second.pmt, pmt);
+    }
+}
+
+void Muxer::updatePsiTable(PsiTable& psiTable, const std::string& signature, uint16_t pid, ts::AbstractLongTable& table) {
+    uint8_t version = psiTable.getNextVersion();
+    table.version = version;
+
+    ts::BinaryTable binaryTable;
+    table.serialize(duck, binaryTable);
+
+    ts::OneShotPacketizer packetizer(duck, pid);
+    std::vector<uint8_t> packets;
+    for (size_t i = 0; i < binaryTable.sectionCount(); i++) {
+        packetizer.addSection(binaryTable.sectionAt(i));
+
+        ts::TSPacketVector tsPackets;
+        packetizer.getPackets(tsPackets);
+        for (auto& packet : tsPackets) {
+            packets.insert(packets.end(), packet.b, packet.b + ts::PKT_SIZE);
+        }
+    }
+
+    psiTable.update(signature, version, std::move(packets));
+}
+
+void Muxer::copyPsiTable(PsiTable& psiTable, const PsiTable& source) {
+    if (psiTable.hasChanged(source.getSignature())) {
+        psiTable.update(source.getSignature(), source.getVersion(), std::vector<uint8_t>(source.getPackets()));
+    }
+}
+
+void Muxer::writePsiTable(PsiTable& psiTable, uint64_t interval, uint64_t now, std::vector<uint8_t>& output) {
+    psiTable.setInterval(interval);
+    if (!psiTable.isDue(now)) {
+        return;
+    }
+
+    const std::vector<uint8_t>& packets = psiTable.getPackets();
+    output.insert(output.end(), packets.begin(), packets.end());
+
+    psiTable.onSent(now);
+}
+
+void Muxer::selectPsiClockService() {
+    if (psiClockServiceIdx && mapServiceHasVideo[*psiClockServiceIdx]) {
+        return;
+    }
+
+    // The lowest index keeps the choice the same from run to run
+    std::optional<uint32_t> selected;
+    bool selectedHasVideo = false;
+    for (const auto& [serviceIdx, hasVideo] : mapServiceHasVideo) {
+        if (!selected || (hasVideo && !selectedHasVideo) || (hasVideo == selectedHasVideo && serviceIdx < *selected)) {
+            selected = serviceIdx;
+            selectedHasVideo = hasVideo;
+        }
+    }
+    psiClockServiceIdx = selected;
+}
+
+void Muxer::writePsi(uint32_t serviceIdx, uint64_t dts, std::vector<uint8_t>& output) {
+    if (!ready || !psiClockServiceIdx) {
+        return;
+    }
+
+    uint64_t psiInterval = static_cast<uint64_t>(config.psiIntervalMs) * 90;
+    uint64_t siInterval = static_cast<uint64_t>(config.siIntervalMs) * 90;
+
+    if (*psiClockServiceIdx == serviceIdx) {
+        writePsiTable(pat, psiInterval, dts, output);
+    }
+
+    auto it = mapPmt.find(serviceIdx);
+    if (it != mapPmt.end()) {
+        writePsiTable(it->second, psiInterval, dts, output);
+    }
+
+    if (*psiClockServiceIdx == serviceIdx) {
+        writePsiTable(sdt, siInterval, dts, output);
+        writePsiTable(nit, siInterval, dts, output);
+    }
+}
+
+bool Muxer::isRandomAccessPoint(const TsInterleaver::Entry& entry) const {
+    if (entry.randomAccess) {
+        return true;
+    }
+    auto it = mapServiceHasVideo.find(entry.serviceIdx);
+    return it != mapServiceHasVideo.end() && !it->second;
+}
+
+bool Muxer::shouldSplit(const TsInterleaver::Entry& entry) {
+    if (!splitCallback || !ready || !isRandomAccessPoint(entry)) {
+        return false;
+    }
+    if (psiClockServiceIdx != entry.serviceIdx) {
+        return false;
+    }
+    if (!splitCallback(entry.dts)) {
+        return false;
+    }
+
+    pat.resend();
+    sdt.resend();
+    nit.resend();
+    for (auto& [serviceIdx, pmt] : mapPmt) {
+        pmt.resend();
+    }
+    return true;
+}
+
+void Muxer::writeServiceOutput(const TsInterleaver::Entry& entry) {
+    auto it = mapServiceOutput.find(entry.serviceIdx);
+    if (it == mapServiceOutput.end()) {
+        return;
+    }
+    ServiceOutput& serviceOutput = it->second;
+
+    if (ready) {
+        if (serviceSplitCallback && isRandomAccessPoint(entry) && serviceSplitCallback(serviceOutput.serviceId, entry.dts)) {
+            serviceOutput.pat.resend();
+            serviceOutput.pmt.resend();
+            serviceOutput.sdt.resend();
+            serviceOutput.nit.resend();
+        }
+
+        uint64_t psiInterval = static_cast<uint64_t>(config.psiIntervalMs) * 90;
+        uint64_t siInterval = static_cast<uint64_t>(config.siIntervalMs) * 90;
+        writePsiTable(serviceOutput.pat, psiInterval, entry.dts, psiBuffer);
+        writePsiTable(serviceOutput.pmt, psiInterval, entry.dts, psiBuffer);
+        writePsiTable(serviceOutput.sdt, siInterval, entry.dts, psiBuffer);
+        writePsiTable(serviceOutput.nit, siInterval, entry.dts, psiBuffer);
+    }
+    if (psiBuffer.size() > 0) {
+        serviceOutput.psiPacketizer.stampContinuityCounters(psiBuffer.data(), psiBuffer.size());
+        serviceOutputCallback(serviceOutput.serviceId, psiBuffer.data(), psiBuffer.size(), entry.dts);
+        psiBuffer.clear();
+    }
+
+    serviceOutputCallback(serviceOutput.serviceId, entry.packets.data(), entry.packets.size(), entry.dts);
+}
+
+PcrScheduler& Muxer::getPcrScheduler(uint32_t serviceIdx) {
+    PcrScheduler& scheduler = mapPcrScheduler[serviceIdx];
+    scheduler.setInterval(static_cast<uint64_t>(config.pcrIntervalMs) * 27000);
+    return scheduler;
+}
+
+void Muxer::queuePes(uint32_t serviceIdx, uint16_t pid, uint64_t dts, bool randomAccess) {
+    interleaver.push(pid, serviceIdx, dts, randomAccess, std::move(tsBuffer));
+    tsBuffer = interleaver.acquire();
+
+    writeInterleaved(false);
+}
+
+void Muxer::updateInterleaverHolds() {
+    interleaver.clearHolds();
+
+    for (const auto& [pid, aggregator] : mapAudioPesAggregator) {
+        if (!aggregator.isEmpty()) {
+            interleaver.hold(pid, aggregator.getPts());
+        }
+    }
+
+    if (audioTranscoder) {
+        pendingTranscodes.clear();
+        audioTranscoder->getPending(pendingTranscodes);
+        for (const auto& pending : pendingTranscodes) {
+            interleaver.hold(pending.pid, pending.pts);
+        }
+    }
+}
+
+void Muxer::writeInterleaved(bool flush) {
+    interleaver.setWindow(static_cast<uint64_t>(config.interleaveWindowMs) * 90);
+    updateInterleaverHolds();
+
+    TsInterleaver::Entry entry;
+    while (interleaver.pop(entry, flush)) {
+        if (shouldSplit(entry)) {
+            // The PMTs of the other services would otherwise wait for a PES of their own
+            writePsi(entry.serviceIdx, entry.dts, psiBuffer);
+            for (auto& [serviceIdx, pmt] : mapPmt) {
+                if (serviceIdx != entry.serviceIdx) {
+                    writePsi(serviceIdx, entry.dts, psiBuffer);
+                }
+            }
+        }
+
+        // PSI goes out in front of the PES that makes it due
+        writePsi(entry.serviceIdx, entry.dts, psiBuffer);
+        if (psiBuffer.size() > 0) {
+            tsPacketizer.stampContinuityCounters(psiBuffer.data(), psiBuffer.size());
+            if (outputCallback) {
+                outputCallback(psiBuffer.data(), psiBuffer.size(), entry.dts);
+            }
+            psiBuffer.clear();
+        }
+
+        tsPacketizer.stampContinuityCounters(entry.packets.data(), entry.packets.size());
+        if (outputCallback) {
+            outputCallback(entry.packets.data(), entry.packets.size(), entry.dts);
+        }
+        if (serviceOutputCallback) {
+            writeServiceOutput(entry);
+        }
+        interleaver.release(std::move(entry.packets));
+    }
+}
+
+void Muxer::writeAudioPes(uint32_t serviceIdx, uint16_t pcrOnlyPid, uint16_t pid, const PESPacket& pes, const std::vector<PesChunk>& payload, uint64_t duration) {
+    PcrScheduler& pcrScheduler = getPcrScheduler(serviceIdx);
+    bool writesPcr = pcrScheduler.getPid() == pcrOnlyPid;
+    if (writesPcr) {
+        uint64_t pcr = calcPcr(pes.getDts());
+        if (pcrScheduler.isDue(pcr)) {
+            tsPacketizer.writePcr(pcrOnlyPid, pcr, tsBuffer);
+            pcrScheduler.onPcr(pcr);
+        }
+    }
+
+    tsPacketizer.writePes(pid, pes, payload, tsBuffer);
+    queuePes(serviceIdx, pid, pes.getDts());
+
+    if (!writesPcr) {
+        return;
+    }
+
+    // A PES that plays longer than the PCR interval would leave a gap until the next one, so the
+    // PCRs that fall due while it plays are queued on their own and the interleaver puts them in place
+    uint64_t pesPcr = calcPcr(pes.getDts());
+    uint64_t endPcr = pesPcr + duration * 300;
+    while (true) {
+        std::optional<uint64_t> pcr = pcrScheduler.getNextPcr();
+        if (!pcr || *pcr < pesPcr || *pcr >= endPcr) {
+            break;
+        }
+        tsPacketizer.writePcr(pcrOnlyPid, *pcr, tsBuffer);
+        pcrScheduler.onPcr(*pcr);
+        queuePes(serviceIdx, pcrOnlyPid, pes.getDts() + (*pcr - pesPcr) / 300);
+    }
+}
+
+void Muxer::writeAdtsFrame(uint32_t serviceIdx, uint16_t pcrOnlyPid, uint16_t pid, const uint8_t* header, size_t headerSize, const std::vector<uint8_t>& data, uint64_t pts) {
+    AudioPesAggregator& aggregator = mapAudioPesAggregator[pid];
+    aggregator.setLimits(config.audioPesFrames, static_cast<uint64_t>(config.audioPesDurationMs) * 90);
+
+    if (aggregator.shouldFlushBefore(pts, headerSize + data.size())) {
+        flushAudioPes(pid, aggregator);
+    }
+
+    aggregator.setService(serviceIdx, pcrOnlyPid);
+    aggregator.add(header, headerSize, data, pts);
+
+    if (aggregator.isFull()) {
+        flushAudioPes(pid, aggregator);
+    }
+}
+
+void Muxer::flushAudioPes(uint16_t pid, AudioPesAggregator& aggregator) {
+    if (aggregator.isEmpty()) {
+        return;
+    }
+
+    PESPacket pes;
+    pes.setPts(aggregator.getPts());
+    pes.setDts(aggregator.getPts());
+    pes.setStreamId(STREAM_ID_AUDIO_STREAM_0);
+    pes.setDataAlignmentIndicator(true);
+    const std::vector<uint8_t>& payload = aggregator.getPayload();
+    pesPayload.assign({ { payload.data(), payload.size() } });
+    writeAudioPes(aggregator.getServiceIdx(), aggregator.getPcrOnlyPid(), pid, pes, pesPayload, aggregator.getDuration());
+
+    aggregator.clear();
+}
+
+void Muxer::writeTranscodedAudio() {
+    if (!audioTranscoder) {
+        return;
+    }
+
+    std::vector<AudioTranscoder::Output> outputs;
+    audioTranscoder->poll(outputs);
+
+    for (const auto& output : outputs) {
+        auto it = mapAudioLoadShedder.find(output.streamKey);
+        if (it != mapAudioLoadShedder.end() && it->second.getLevel() == AudioLoadShedder::Level::Passthrough) {
+            // The PID carries MPEG-H now
+            continue;
+        }
+
+        // The encoder already puts an ADTS header in front of each frame
+        const AudioTranscoder::Target& target = output.target;
+        for (const auto& frame : output.frames) {
+            auto resume = mapAudioResumePts.find(output.streamKey);
+            if (resume != mapAudioResumePts.end()) {
+                if (frame.pts < resume->second) {
+                    continue;
+                }
+                mapAudioResumePts.erase(resume);
+            }
+            writeAdtsFrame(target.serviceIdx, target.pcrOnlyPid, target.pid, nullptr, 0, frame.data, frame.pts);
+        }
+    }
+}
+
+bool Muxer::isMpeghPassthrough(const atsc3::Service& service, const atsc3::MediaStream& stream) const {
+    if (!canPassThroughMpegh(stream)) {
+        return false;
+    }
+    if (config.mpeghPassthrough) {
+        return true;
+    }
+
+    auto it = mapAudioLoadShedder.find(calcStreamKey(service, stream));
+    return it != mapAudioLoadShedder.end() && it->second.getLevel() == AudioLoadShedder::Level::Passthrough;
+}
+
+AudioTranscoder::Quality Muxer::shedAudioLoad(const atsc3::Service& service, const atsc3::MediaStream& stream, uint64_t dts) {
+    uint32_t streamKey = calcStreamKey(service, stream);
+    AudioLoadShedder& shedder = mapAudioLoadShedder[streamKey];
+    shedder.setBudget(static_cast<uint64_t>(config.audioLagBudgetMs) * 90);
+
+    uint64_t lag = audioTranscoder->getLag(streamKey);
+    AudioLoadShedder::Level previous = shedder.getLevel();
+    if (shedder.update(lag, dts, canPassThroughMpegh(stream))) {
+        const char* step = "";
+        bool lowered = shedder.getLevel() > previous;
+        if (lowered) {
+            switch (shedder.getLevel()) {
+            case AudioLoadShedder::Level::NoAfterburner:
+                step = "disabling the AAC afterburner";
+                break;
+            case AudioLoadShedder::Level::LowerLayout:
+                step = "lowering the render layout";
+                break;
+            case AudioLoadShedder::Level::Passthrough:
+                step = "passing MPEG-H through";
+                // AAC frames still waiting for their PES would land on an MPEG-H PID
+                mapAudioPesAggregator[calcPesPid(service, stream.idx)].clear();
+                break;
+            default:
+                break;
+            }
+        }
+        else {
+            switch (previous) {
+            case AudioLoadShedder::Level::NoAfterburner:
+                step = "enabling the AAC afterburner";
+                break;
+            case AudioLoadShedder::Level::LowerLayout:
+                step = "restoring the render layout";
+                break;
+            case AudioLoadShedder::Level::Passthrough:
+                step = "transcoding MPEG-H again";
+                // Nothing the transcoder held from before may follow the MPEG-H already written
+                audioTranscoder->restart(streamKey);
+                mapAudioResumePts[streamKey] = dts;
+                break;
+            default:
+                break;
+            }
+        }
+        if (lowered) {
+            fprintf(stderr, "[Audio] Service %u stream %u is %llu ms behind, %s\n",
+                service.serviceId, stream.idx, static_cast<unsigned long long>(lag / 90), step);
+        }
+        else {
+            fprintf(stderr, "[Audio] Service %u stream %u has kept up, %s\n", service.serviceId, stream.idx, step);
+        }
+
+        // The PMT gets the new stream type and version right away
+        auto it = mapPmtStreams.find(service.idx);
+        if ((previous == AudioLoadShedder::Level::Passthrough || shedder.getLevel() == AudioLoadShedder::Level::Passthrough) && it != mapPmtStreams.end()) {
+            onPmt(service, it->second);
+        }
+    }
+
+    AudioTranscoder::Quality quality;
+    quality.layout = selectMpeghLayout(service, stream);
+    quality.afterburner = shedder.getLevel() == AudioLoadShedder::Level::Full;
+    if (shedder.getLevel() >= AudioLoadShedder::Level::LowerLayout) {
+        quality.layout = lowerMpeghLayout(quality.layout);
+    }
+    return quality;
+}
+
+void Muxer::flush() {
+    if (audioTranscoder) {
+        audioTranscoder->wait();
+        writeTranscodedAudio();
+    }
+
+    for (auto& [pid, aggregator] : mapAudioPesAggregator) {
+        flushAudioPes(pid, aggregator);
+    }
+
+    writeInterleaved(true);
+}
+
+void Muxer::onStreamData(const atsc3::Service& service, const atsc3::MediaStream& stream, const std::vector<StreamPacket>& packets) {
+    writeTranscodedAudio();
+
+    if (!hasPesPid(stream.idx)) {
+        return;
+    }
+
+    uint16_t pid = calcPesPid(service, stream.idx);
+    AVRational r = { 1, static_cast<int>(stream.mp4CodecConfig.timescale) };
+    AVRational ts = { 1, 90000 };
+    uint64_t baseDts = av_rescale_q(packets[0].dts, r, ts);
+    PcrScheduler& pcrScheduler = getPcrScheduler(service.idx);
+
+    if (stream.getStreamType() == atsc3::StreamType::VIDEO) {
+        if (pcrScheduler.getPid() == 0x1fff) {
+            pcrScheduler.setPid(pid);
+        }
+
+        HevcParameterSetTracker& tracker = mapHevcTracker[pid];
+        tracker.update(stream.mp4CodecConfig.prefixNalUnits);
+
+        uint64_t frameDuration = 0;
+        for (size_t j = 0; j < packets.size(); j++) {
+            const StreamPacket& packet = packets[j];
+            uint64_t dts = av_rescale_q(packet.dts, r, ts);
+            uint64_t pts = av_rescale_q(packet.pts, r, ts);
+            if (j + 1 < packets.size()) {
+                frameDuration = av_rescale_q(packets[j + 1].dts, r, ts) - dts;
+            }
+
+            HevcSampleInfo hevcInfo;
+            if (!hevcProcess(stream.mp4CodecConfig, packet, tracker, pesPayload, hevcInfo)) {
+                fprintf(stderr, "[Muxer] Dropping a malformed HEVC sample (pid=0x%04x, dts=%llu)\n",
+                    pid, static_cast<unsigned long long>(dts));
+                continue;
+            }
+
+            PESPacket pes;
+            pes.setPts(pts);
+            pes.setDts(dts);
+            pes.setStreamId(STREAM_ID_VIDEO_STREAM_0);
+            if (hevcInfo.hasAccessUnitDelimiter) {
+                pes.setDataAlignmentIndicator(true);
+            }
+
+            bool carriesPcr = pid == pcrScheduler.getPid();
+            tsPacketizer.writePes(pid, pes, pesPayload, hevcInfo.randomAccess, [&](size_t i, size_t packetCount) {
+                if (!carriesPcr) {
+                    return TsPacketizer::noPcr;
+                }
+
+                // The packets of a picture are spread evenly up to the next picture
+                uint64_t pcr = calcPcr(dts) + frameDuration * 300 * i / packetCount;
+                if (i != 0 && !pcrScheduler.isDue(pcr)) {
+                    return TsPacketizer::noPcr;
+                }
+                pcrScheduler.onPcr(pcr);
+                return pcr;
+            }, tsBuffer);
+            queuePes(service.idx, pid, dts, hevcInfo.randomAccess);
+        }
+    }
+    else if (stream.getStreamType() == atsc3::StreamType::AUDIO) {
+        if (stream.getCodecType() == atsc3::CodecType::AAC) {
+            const std::vector<uint8_t>& audioSpecificConfig = stream.mp4CodecConfig.decoderSpecificInfo;
+            auto it = mapAdtsHeader.find(pid);
+            if (it == mapAdtsHeader.end() || it->second.getAudioSpecificConfig() != audioSpecificConfig) {
+                AdtsHeader adtsHeader;
+                if (!adtsHeader.parse(audioSpecificConfig)) {
+                    fprintf(stderr, "[Muxer] Unsupported AudioSpecificConfig for ADTS (pid=0x%04x)\n", pid);
+                }
+                it = mapAdtsHeader.insert_or_assign(pid, std::move(adtsHeader)).first;
+            }
+            if (!it->second.isValid()) {
+                return;
+            }
+
+            std::array<uint8_t, AdtsHeader::headerSize> header;
+            for (const auto& packet : packets) {
+                if (!it->second.write(packet.data.size(), header)) {
+                    continue;
+                }
+
+                // Audio frames are presented in decoding order, so the PTS alone times them
+                writeAdtsFrame(service.idx, calcPcrOnlyPid(service), pid, header.data(), header.size(), packet.data, av_rescale_q(packet.pts, r, ts));
+            }
+            return;
+        }
+
+        AudioTranscoder::Quality quality;
+        // A stream the load shedder passes through still goes through it, to be transcoded again later
+        if (!config.mpeghPassthrough || !canPassThroughMpegh(stream)) {
+            if (!audioTranscoder) {
+                uint32_t threads = config.audioThreads;
+                if (threads == 0) {
+                    threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+                }
+                audioTranscoder = std::make_unique<AudioTranscoder>(threads);
+                // Past the window the demuxer waits for the transcoder, which holds up the video too. The
+                // lag budget comes on top, so that the load is shed before the demuxer ever has to wait
+                audioTranscoder->setMaxQueuedDuration((static_cast<uint64_t>(config.interleaveWindowMs) + config.audioLagBudgetMs) * 90);
+            }
+            // May switch the stream over to passthrough and back
+            quality = shedAudioLoad(service, stream, baseDts);
+        }
+
+        if (isMpeghPassthrough(service, stream)) {
+            for (const auto& packet : packets) {
+                PESPacket pes;
+                pes.setPts(av_rescale_q(packet.pts, r, ts));
+                pes.setDts(av_rescale_q(packet.dts, r, ts));
+                pes.setStreamId(STREAM_ID_AUDIO_STREAM_0);
+                pes.setDataAlignmentIndicator(true);
+                pesPayload.assign({ { packet.data.data(), packet.data.size() } });
+                writeAudioPes(service.idx, calcPcrOnlyPid(service), pid, pes, pesPayload);
+            }
+            return;
+        }
+
+        AudioTranscoder::Target target;
+        target.serviceIdx = service.idx;
+        target.pcrOnlyPid = calcPcrOnlyPid(service);
+        target.pid = pid;
+
+        audioTranscoder->submit(calcStreamKey(service, stream), quality, stream.mp4CodecConfig.timescale, packets, target);
+    }
+
+
+}
@@ -1,33 +1,442 @@
-#pragma once
-#include <string>
-#include <unordered_map>
-#include <list>
-#include <functional>
-#include <tsduck.h>
-#include "streamPacket.h"
-#include "demuxerHandler.h"
-#include "serviceManager.h"
-#include "aacEncoder.h"
-
-struct AVCodecContext;
-class MpeghDecoder;
-class Muxer : public atsc3::DemuxerHandler {
-public:
-    using OutputCallback = std::function<void(const uint8_t*, size_t, uint64_t)>;
-    void setOutputCallback(OutputCallback cb);
-
-private:
-    virtual void onSlt(const atsc3::ServiceManager& sm) override;
-    virtual void onPmt(const atsc3::Service& service, std::vector<std::reference_wrapper<atsc3::MediaStream>> streams) override;
-    virtual void onStreamData(const atsc3::Service& service, const atsc3::MediaStream& stream, const std::vector<StreamPacket>& chunks) override;
-
-    std::unordered_map<uint16_t, uint8_t> mapCC;
-    OutputCallback outputCallback;
-    ts::DuckContext duck;
-
-    std::map<uint32_t, AacEncoder> mapAACEncoder;
-    std::map<uint32_t, MpeghDecoder*> mapMpeghDecoder;
-    
-    bool ready{ false };
-
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <list>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <tsduck.h>
+#include "streamPacket.h"
+#include "demuxerHandler.h"
+#include "serviceManager.h"
+#include "aacEncoder.h"
+#include "adtsHeader.h"
+#include "audioTranscoder.h"
+#include "tsPacketizer.h"
+#include "tsInterleaver.h"
+
+struct AVCodecContext;
+
+// Decides where the hvcC parameter sets are inserted into an HEVC stream: before random
+// access points, and before the first picture after the parameter sets change.
+// Samples that carry their own parameter sets are left alone.
+class HevcParameterSetTracker {
+public:
+    void update(const std::vector<uint8_t>& parameterSets) {
+        if (parameterSets != this->parameterSets) {
+            this->parameterSets = parameterSets;
+            changed = true;
+        }
+    }
+
+    bool shouldInsert(bool randomAccess, bool hasInBandParameterSets) {
+        if (hasInBandParameterSets) {
+            changed = false;
+            return false;
+        }
+        if (!randomAccess && !changed) {
+            return false;
+        }
+
+        changed = false;
+        return parameterSets.size() > 0;
+    }
+
+    const std::vector<uint8_t>& getParameterSets() const {
+        return parameterSets;
+    }
+
+private:
+    std::vector<uint8_t> parameterSets;
+    bool changed{ false };
+};
+
+// Tracks the PCR PID of a service and decides when a PCR is written.
+// Times are in 27 MHz units.
+class PcrScheduler {
+public:
+    uint16_t getPid() const {
+        return pid;
+    }
+
+    void setPid(uint16_t pid) {
+        this->pid = pid;
+    }
+
+    bool isDue(uint64_t pcr) const {
+        // A PCR going backwards is a discontinuity and restarts the schedule
+        return !hasLastPcr || pcr < lastPcr || pcr - lastPcr >= interval;
+    }
+
+    void setInterval(uint64_t interval) {
+        this->interval = interval;
+    }
+
+    void onPcr(uint64_t pcr) {
+        lastPcr = pcr;
+        hasLastPcr = true;
+    }
+
+    // When the next PCR is due at the latest
+    std::optional<uint64_t> getNextPcr() const {
+        if (!hasLastPcr || interval == 0) {
+            return std::nullopt;
+        }
+        return lastPcr + interval;
+    }
+
+private:
+    uint16_t pid{ 0x1fff };
+    uint64_t interval{ 0 };
+    uint64_t lastPcr{ 0 };
+    bool hasLastPcr{ false };
+};
+
+// Packetized PSI table that is sent again on a fixed interval. The packets are only built
+// again when the table content changes, which also bumps the version.
+// Continuity counters are filled in when the packets are sent. Times are in 90 kHz units.
+class PsiTable {
+public:
+    // The signature covers everything the table is built from
+    bool hasChanged(const std::string& signature) const {
+        return !hasPackets || signature != this->signature;
+    }
+
+    const std::string& getSignature() const {
+        return signature;
+    }
+
+    uint8_t getVersion() const {
+        return version;
+    }
+
+    uint8_t getNextVersion() const {
+        return hasPackets ? (version + 1) & 0x1F : 0;
+    }
+
+    void update(const std::string& signature, uint8_t version, std::vector<uint8_t>&& packets) {
+        this->signature = signature;
+        this->version = version;
+        this->packets = std::move(packets);
+        hasPackets = true;
+        // A new version goes out with the next media packet
+        hasLastSent = false;
+    }
+
+    void setInterval(uint64_t interval) {
+        this->interval = interval;
+    }
+
+    bool isDue(uint64_t now) const {
+        // Time going backwards is a discontinuity and restarts the schedule
+        return hasPackets && (!hasLastSent || now < lastSent || now - lastSent >= interval);
+    }
+
+    // Sends the table with the next media packet regardless of the interval
+    void resend() {
+        hasLastSent = false;
+    }
+
+    void onSent(uint64_t now) {
+        lastSent = now;
+        hasLastSent = true;
+    }
+
+    const std::vector<uint8_t>& getPackets() const {
+        return packets;
+    }
+
+private:
+    std::string signature;
+    uint8_t version{ 0 };
+    std::vector<uint8_t> packets;
+    bool hasPackets{ false };
+    uint64_t interval{ 0 };
+    uint64_t lastSent{ 0 };
+    bool hasLastSent{ false };
+};
+
+// Steps the transcoding of an audio stream down while it lags behind real time, trading audio
+// quality for keeping up, and back up once it has kept up for a while. Times are in 90 kHz units.
+class AudioLoadShedder {
+public:
+    enum class Level {
+        Full,
+        NoAfterburner,
+        LowerLayout,
+        Passthrough,
+    };
+
+    Level getLevel() const {
+        return level;
+    }
+
+    void setBudget(uint64_t budget) {
+        this->budget = budget;
+    }
+
+    // Returns true when the level has changed
+    bool update(uint64_t lag, uint64_t now, bool canPassthrough) {
+        if (budget == 0) {
+            return false;
+        }
+        // The previous step gets one budget worth of media time to show an effect
+        bool settled = !hasLastStep || now < lastStep || now - lastStep >= budget;
+
+        Level lowest = canPassthrough ? Level::Passthrough : Level::LowerLayout;
+        if (lag > budget) {
+            hasCalmSince = false;
+            if (level >= lowest || !settled) {
+                return false;
+            }
+            // Lowered again after having been raised, so the load goes up and down; waits longer next time
+            if (raised) {
+                recoveryHold = std::min(recoveryHold * 2, maxRecoveryHold);
+                raised = false;
+            }
+            step(static_cast<Level>(static_cast<int>(level) + 1), now);
+            return true;
+        }
+
+        // A level is raised once the lag has stayed at or below half the budget for the hold time
+        if (level == Level::Full || lag > budget / 2) {
+            hasCalmSince = false;
+            return false;
+        }
+        if (!hasCalmSince || now < calmSince) {
+            calmSince = now;
+            hasCalmSince = true;
+            return false;
+        }
+        if (!settled || now - calmSince < recoveryHold) {
+            return false;
+        }
+
+        step(static_cast<Level>(static_cast<int>(level) - 1), now);
+        hasCalmSince = false;
+        raised = true;
+        return true;
+    }
+
+private:
+    static constexpr uint64_t minRecoveryHold = 90000 * 60;
+    static constexpr uint64_t maxRecoveryHold = 90000 * 60 * 30;
+
+    void step(Level level, uint64_t now) {
+        this->level = level;
+        lastStep = now;
+        hasLastStep = true;
+    }
+
+    Level level{ Level::Full };
+    uint64_t budget{ 0 };
+    uint64_t lastStep{ 0 };
+    bool hasLastStep{ false };
+    uint64_t calmSince{ 0 };
+    bool hasCalmSince{ false };
+    uint64_t recoveryHold{ minRecoveryHold };
+    bool raised{ false };
+};
+
+// Collects consecutive ADTS frames of one PID into a single PES packet,
+// which is timestamped with the first frame. Times are in 90 kHz units.
+class AudioPesAggregator {
+public:
+    void setLimits(uint32_t maxFrames, uint64_t maxDuration) {
+        // Without any limit every frame gets its own PES
+        this->maxFrames = maxFrames == 0 && maxDuration == 0 ? 1 : maxFrames;
+        this->maxDuration = maxDuration;
+    }
+
+    void setService(uint32_t serviceIdx, uint16_t pcrOnlyPid) {
+        this->serviceIdx = serviceIdx;
+        this->pcrOnlyPid = pcrOnlyPid;
+    }
+
+    uint32_t getServiceIdx() const {
+        return serviceIdx;
+    }
+
+    uint16_t getPcrOnlyPid() const {
+        return pcrOnlyPid;
+    }
+
+    // Whether the pending frames have to be written before this one is added
+    bool shouldFlushBefore(uint64_t pts, size_t size) const {
+        if (frameCount == 0) {
+            return false;
+        }
+        // Only the first frame has a timestamp, so the frames must follow each other
+        if (pts <= lastPts || (frameDuration != 0 && pts - lastPts > frameDuration * 2)) {
+            return true;
+        }
+        if (maxDuration != 0 && pts - firstPts >= maxDuration) {
+            return true;
+        }
+        return payload.size() + size > maxPayloadSize;
+    }
+
+    void add(const uint8_t* header, size_t headerSize, const std::vector<uint8_t>& data, uint64_t pts) {
+        if (frameCount == 0) {
+            firstPts = pts;
+            frameDuration = 0;
+        }
+        else {
+            frameDuration = pts - lastPts;
+        }
+        lastPts = pts;
+        ++frameCount;
+
+        payload.insert(payload.end(), header, header + headerSize);
+        payload.insert(payload.end(), data.begin(), data.end());
+    }
+
+    bool isFull() const {
+        return maxFrames != 0 && frameCount >= maxFrames;
+    }
+
+    bool isEmpty() const {
+        return frameCount == 0;
+    }
+
+    uint64_t getPts() const {
+        return firstPts;
+    }
+
+    // The last frame is taken to be as long as the one before it
+    uint64_t getDuration() const {
+        return frameCount == 0 ? 0 : lastPts - firstPts + frameDuration;
+    }
+
+    const std::vector<uint8_t>& getPayload() const {
+        return payload;
+    }
+
+    void clear() {
+        payload.clear();
+        frameCount = 0;
+    }
+
+private:
+    // Keeps PES_packet_length within 16 bits
+    static constexpr size_t maxPayloadSize = 0xFFFF - 13;
+
+    uint32_t maxFrames{ 1 };
+    uint64_t maxDuration{ 0 };
+    uint32_t serviceIdx{ 0 };
+    uint16_t pcrOnlyPid{ 0 };
+    std::vector<uint8_t> payload;
+    uint32_t frameCount{ 0 };
+    uint64_t firstPts{ 0 };
+    uint64_t lastPts{ 0 };
+    uint64_t frameDuration{ 0 };
+};
+
+class Muxer : public atsc3::DemuxerHandler {
+public:
+    using OutputCallback = std::function<void(const uint8_t*, size_t, uint64_t)>;
+    void setOutputCallback(OutputCallback cb);
+
+    // Asked before each random access point of the service that PAT, SDT and NIT follow, with its DTS.
+    // Returning true makes it the start of a new segment: every PSI table is written again right in
+    // front of it, so the output from there on plays without what came before.
+    // In a service without video, every PES is a random access point.
+    using SplitCallback = std::function<bool(uint64_t)>;
+    void setSplitCallback(SplitCallback cb);
+
+    // Also writes every media service as an SPTS of its own: its PIDs with a PAT and SDT that only
+    // list the service. Called with the service ID. Set before demuxing starts.
+    using ServiceOutputCallback = std::function<void(uint32_t, const uint8_t*, size_t, uint64_t)>;
+    void setServiceOutputCallback(ServiceOutputCallback cb);
+
+    // The split callback of the SPTS outputs, asked before each random access point of a service
+    // with the service ID and the DTS. Returning true writes the PSI of that SPTS again in front of it.
+    using ServiceSplitCallback = std::function<bool(uint32_t, uint64_t)>;
+    void setServiceSplitCallback(ServiceSplitCallback cb);
+
+    // Called with the IDs of the media services whenever the SLT changes them
+    using ServiceListCallback = std::function<void(const std::vector<uint32_t>&)>;
+    void setServiceListCallback(ServiceListCallback cb);
+
+    // Writes out everything still held back: audio being transcoded, partly filled PES and the interleaver
+    void flush();
+
+private:
+    virtual void onSlt(const atsc3::ServiceManager& sm) override;
+    virtual void onPmt(const atsc3::Service& service, std::vector<std::reference_wrapper<atsc3::MediaStream>> streams) override;
+    virtual void onStreamData(const atsc3::Service& service, const atsc3::MediaStream& stream, const std::vector<StreamPacket>& chunks) override;
+
+    // The PSI of the SPTS of one service. The PES PIDs belong to the service alone, so their continuity
+    // counters carry over from the MPTS, but PAT, SDT and NIT need counters of their own.
+    struct ServiceOutput {
+        uint32_t serviceId{ 0 };
+        PsiTable pat;
+        PsiTable pmt;
+        PsiTable sdt;
+        PsiTable nit;
+        TsPacketizer psiPacketizer;
+    };
+
+    PcrScheduler& getPcrScheduler(uint32_t serviceIdx);
+    void updatePsiTable(PsiTable& psiTable, const std::string& signature, uint16_t pid, ts::AbstractLongTable& table);
+    // Takes over the packets of a table that is sent on another schedule
+    void copyPsiTable(PsiTable& psiTable, const PsiTable& source);
+    void writePsiTable(PsiTable& psiTable, uint64_t interval, uint64_t now, std::vector<uint8_t>& output);
+    void writePsi(uint32_t serviceIdx, uint64_t dts, std::vector<uint8_t>& output);
+    void selectPsiClockService();
+    bool isRandomAccessPoint(const TsInterleaver::Entry& entry) const;
+    bool shouldSplit(const TsInterleaver::Entry& entry);
+    void writeServiceOutput(const TsInterleaver::Entry& entry);
+    // Hands the packets written to tsBuffer for one PES over to the interleaver
+    void queuePes(uint32_t serviceIdx, uint16_t pid, uint64_t dts, bool randomAccess = false);
+    // Tells the interleaver about audio that is still being transcoded or collected into a PES
+    void updateInterleaverHolds();
+    void writeInterleaved(bool flush);
+    // The duration is how long the PES plays, which is only known for aggregated frames
+    void writeAudioPes(uint32_t serviceIdx, uint16_t pcrOnlyPid, uint16_t pid, const PESPacket& pes, const std::vector<PesChunk>& payload, uint64_t duration = 0);
+    void writeAdtsFrame(uint32_t serviceIdx, uint16_t pcrOnlyPid, uint16_t pid, const uint8_t* header, size_t headerSize, const std::vector<uint8_t>& data, uint64_t pts);
+    void flushAudioPes(uint16_t pid, AudioPesAggregator& aggregator);
+    void writeTranscodedAudio();
+    bool isMpeghPassthrough(const atsc3::Service& service, const atsc3::MediaStream& stream) const;
+    AudioTranscoder::Quality shedAudioLoad(const atsc3::Service& service, const atsc3::MediaStream& stream, uint64_t dts);
+
+    TsPacketizer tsPacketizer;
+    TsInterleaver interleaver;
+    // Taken from the interleaver's recycled buffers so that the TS packets are written into already allocated memory
+    std::vector<uint8_t> tsBuffer;
+    std::vector<uint8_t> psiBuffer;
+    std::vector<PesChunk> pesPayload;
+    std::unordered_map<uint16_t, HevcParameterSetTracker> mapHevcTracker;
+    std::unordered_map<uint32_t, PcrScheduler> mapPcrScheduler;
+    std::unordered_map<uint16_t, AdtsHeader> mapAdtsHeader;
+    OutputCallback outputCallback;
+    SplitCallback splitCallback;
+    ServiceOutputCallback serviceOutputCallback;
+    ServiceSplitCallback serviceSplitCallback;
+    ServiceListCallback serviceListCallback;
+    std::vector<uint32_t> serviceIds;
+    ts::DuckContext duck;
+
+    std::unique_ptr<AudioTranscoder> audioTranscoder;
+    std::vector<AudioTranscoder::Pending> pendingTranscodes;
+    std::unordered_map<uint32_t, AudioLoadShedder> mapAudioLoadShedder;
+    // Where a stream goes back to transcoding after being passed through; earlier frames overlap the MPEG-H
+    std::unordered_map<uint32_t, uint64_t> mapAudioResumePts;
+    PsiTable pat;
+    PsiTable sdt;
+    PsiTable nit;
+    std::unordered_map<uint32_t, PsiTable> mapPmt;
+    // The streams of the last onPmt, to rebuild the PMT when a stream changes its type in the muxer
+    std::unordered_map<uint32_t, std::vector<std::reference_wrapper<atsc3::MediaStream>>> mapPmtStreams;
+    std::unordered_map<uint32_t, ServiceOutput> mapServiceOutput;
+    // PAT, SDT and NIT follow the clock of the first service with video, or of the first service
+    // when none has video
+    std::optional<uint32_t> psiClockServiceIdx;
+    std::unordered_map<uint32_t, bool> mapServiceHasVideo;
+    std::unordered_map<uint16_t, AudioPesAggregator> mapAudioPesAggregator;
+
+    // Set once a PMT is known; PSI is written from then on, with or without video
+    bool ready{ false };
+
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "pcmBuffer.h"
+#include <algorithm>
+#include "pcmConvert.h"
+
+namespace {
+
+// Tolerated mismatch between expected and signaled time before the buffer is resynchronized
+constexpr uint64_t kMaxTimestampDrift = 90000 / 10;
+
+}
+
+bool PcmBuffer::setFormat(uint32_t sampleRate, uint32_t channels) {
+    if (this->sampleRate == sampleRate && this->channels == channels) {
+        return true;
+    }
+
+    this->sampleRate = sampleRate;
+    this->channels = channels;
+    clear();
+    return false;
+}
+
+void PcmBuffer::write(const int32_t* samples, size_t count, uint64_t timestamp) {
+    if (channels == 0 || sampleRate == 0) {
+        return;
+    }
+
+    if (!hasTimestamp) {
+        baseTimestamp = timestamp;
+        consumedSamples = 0;
+        hasTimestamp = true;
+    }
+    else {
+        uint64_t expected = baseTimestamp + ((consumedSamples + size) / channels) * 90000 / sampleRate;
+        uint64_t drift = expected > timestamp ? expected - timestamp : timestamp - expected;
+        if (drift > kMaxTimestampDrift) {
+            readPos = 0;
+            size = 0;
+            baseTimestamp = timestamp;
+            consumedSamples = 0;
+            discontinuity = true;
+        }
+    }
+
+    reserve(size + count);
+
+    size_t capacity = buffer.size();
+    size_t writePos = (readPos + size) % capacity;
+    size_t first = std::min(count, capacity - writePos);
+    pcm::convertS32ToS16(samples, buffer.data() + writePos, first);
+    pcm::convertS32ToS16(samples + first, buffer.data(), count - first);
+    size += count;
+}
+
+const int16_t* PcmBuffer::peek(size_t& count) const {
+    count = std::min(size, buffer.size() - readPos);
+    return buffer.data() + readPos;
+}
+
+void PcmBuffer::consume(size_t count) {
+    count = std::min(count, size);
+    readPos = buffer.size() > 0 ? (readPos + count) % buffer.size() : 0;
+    size -= count;
+    consumedSamples += count;
+}
+
+void PcmBuffer::clear() {
+    if (size > 0 || hasTimestamp) {
+        discontinuity = true;
+    }
+    readPos = 0;
+    size = 0;
+    consumedSamples = 0;
+    // The next write starts a new timeline
+    hasTimestamp = false;
+}
+
+uint64_t PcmBuffer::getTimestamp() const {
+    if (channels == 0 || sampleRate == 0) {
+        return baseTimestamp;
+    }
+    return baseTimestamp + (consumedSamples / channels) * 90000 / sampleRate;
+}
+
+bool PcmBuffer::takeDiscontinuity() {
+    bool result = discontinuity;
+    discontinuity = false;
+    return result;
+}
+
+void PcmBuffer::reserve(size_t count) {
+    if (count <= buffer.size()) {
+        return;
+    }
+
+    // Grow and unwrap, so the samples start at the beginning of the new storage
+    size_t capacity = std::max<size_t>(buffer.size() * 2, 4096);
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    std::vector<int16_t> grown(capacity);
+    for (size_t i = 0; i < size; i++) {
+        grown[i] = buffer[(readPos + i) % buffer.size()];
+    }
+    buffer = std::move(grown);
+    readPos = 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Interleaved 16-bit PCM handed from the MPEG-H decoder to the AAC encoder.
+// It lives as long as the stream, so encoder frames stay continuous across segments.
+class PcmBuffer {
+public:
+    // Returns false if the format changed; buffered samples are dropped in that case
+    bool setFormat(uint32_t sampleRate, uint32_t channels);
+    uint32_t getSampleRate() const { return sampleRate; }
+    uint32_t getChannels() const { return channels; }
+
+    // Appends decoder output. 32-bit samples keep their upper 16 bits.
+    // timestamp is the 90 kHz time of the first sample. It is checked against the time the
+    // samples written so far end at, also once they have all been consumed; a gap marks a
+    // discontinuity and drops what is still buffered.
+    void write(const int32_t* samples, size_t count, uint64_t timestamp);
+
+    // Contiguous run of samples at the read position, at most getSize() long
+    const int16_t* peek(size_t& count) const;
+    void consume(size_t count);
+    size_t getSize() const { return size; }
+    void clear();
+
+    // 90 kHz time of the sample at the read position
+    uint64_t getTimestamp() const;
+
+    // True once after samples were dropped or the format changed
+    bool takeDiscontinuity();
+
+private:
+    void reserve(size_t count);
+
+    std::vector<int16_t> buffer;
+    size_t readPos{ 0 };
+    size_t size{ 0 };
+
+    uint32_t sampleRate{ 0 };
+    uint32_t channels{ 0 };
+    uint64_t baseTimestamp{ 0 };
+    uint64_t consumedSamples{ 0 };
+    bool hasTimestamp{ false };
+    bool discontinuity{ false };
+
+};
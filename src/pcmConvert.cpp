@@ -0,0 +1,117 @@
+#include "pcmConvert.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PCM_CONVERT_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PCM_CONVERT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PCM_CONVERT_TARGET(x) __attribute__((target(x)))
+#else
+#define PCM_CONVERT_TARGET(x)
+#endif
+
+namespace pcm {
+
+namespace {
+
+using ConvertFunction = void (*)(const int32_t*, int16_t*, size_t);
+
+struct ConvertKernel {
+    ConvertFunction function;
+    const char* name;
+};
+
+#ifdef PCM_CONVERT_X86
+
+PCM_CONVERT_TARGET("sse2")
+void convertS32ToS16Sse2(const int32_t* input, int16_t* output, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 4));
+        a = _mm_srai_epi32(a, 16);
+        b = _mm_srai_epi32(b, 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(a, b));
+    }
+    convertS32ToS16Scalar(input + i, output + i, count - i);
+}
+
+PCM_CONVERT_TARGET("avx2")
+void convertS32ToS16Avx2(const int32_t* input, int16_t* output, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 8));
+        a = _mm256_srai_epi32(a, 16);
+        b = _mm256_srai_epi32(b, 16);
+        // packs works per 128-bit lane, so the 64-bit quarters come out as a0 b0 a1 b1
+        __m256i packed = _mm256_packs_epi32(a, b);
+        packed = _mm256_permute4x64_epi64(packed, 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+    convertS32ToS16Sse2(input + i, output + i, count - i);
+}
+
+bool isAvx2Supported() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // AVX and OSXSAVE, and the OS saves the YMM registers
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+        return false;
+    }
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+ConvertKernel selectKernel() {
+#ifdef PCM_CONVERT_X86
+    if (isAvx2Supported()) {
+        return { convertS32ToS16Avx2, "avx2" };
+    }
+    return { convertS32ToS16Sse2, "sse2" };
+#else
+    return { convertS32ToS16Scalar, "scalar" };
+#endif
+}
+
+const ConvertKernel& getKernel() {
+    static const ConvertKernel kernel = selectKernel();
+    return kernel;
+}
+
+}
+
+void convertS32ToS16Scalar(const int32_t* input, int16_t* output, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        output[i] = static_cast<int16_t>(input[i] >> 16);
+    }
+}
+
+void convertS32ToS16(const int32_t* input, int16_t* output, size_t count) {
+    getKernel().function(input, output, count);
+}
+
+const char* getConvertKernelName() {
+    return getKernel().name;
+}
+
+}
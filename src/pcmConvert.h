@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace pcm {
+
+// Converts 32-bit decoder samples to 16-bit by keeping the upper 16 bits.
+// The kernel is chosen once from the CPU features available at run time.
+void convertS32ToS16(const int32_t* input, int16_t* output, size_t count);
+
+void convertS32ToS16Scalar(const int32_t* input, int16_t* output, size_t count);
+
+const char* getConvertKernelName();
+
+}
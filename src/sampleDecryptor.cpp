@@ -0,0 +1,168 @@
+#include "sampleDecryptor.h"
+#include <memory>
+#include <openssl/evp.h>
+#include "config.h"
+
+namespace atsc3 {
+
+AesCtrContext::AesCtrContext() {
+    ctx = EVP_CIPHER_CTX_new();
+}
+
+AesCtrContext::~AesCtrContext() {
+    if (ctx) {
+        EVP_CIPHER_CTX_free(ctx);
+    }
+}
+
+bool AesCtrContext::setKey(const std::array<uint8_t, 16>& key) {
+    if (!ctx) {
+        return false;
+    }
+
+    if (hasKey && this->key == key) {
+        return true;
+    }
+
+    // Expand the key schedule once; each sample only resets the IV afterwards
+    if (1 != EVP_DecryptInit_ex(ctx, EVP_aes_128_ctr(), nullptr, key.data(), nullptr)) {
+        hasKey = false;
+        return false;
+    }
+
+    this->key = key;
+    hasKey = true;
+    return true;
+}
+
+bool AesCtrContext::decrypt(uint8_t* data, size_t size, const std::array<uint8_t, 16>& iv) {
+    if (!hasKey) {
+        return false;
+    }
+
+    if (1 != EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, iv.data())) {
+        return false;
+    }
+
+    // CTR is a stream mode, so decrypting in place never produces trailing bytes
+    int outLength = 0;
+    if (1 != EVP_DecryptUpdate(ctx, data, &outLength, data, static_cast<int>(size))) {
+        return false;
+    }
+
+    return true;
+}
+
+SampleDecryptor& SampleDecryptor::instance() {
+    static SampleDecryptor decryptor(config.decryptThreads);
+    return decryptor;
+}
+
+SampleDecryptor::SampleDecryptor(uint32_t threadCount) {
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+
+    // contexts[0] belongs to the calling thread
+    for (uint32_t i = 0; i < threadCount; i++) {
+        contexts.push_back(std::make_unique<AesCtrContext>());
+    }
+
+    for (uint32_t i = 1; i < threadCount; i++) {
+        workers.emplace_back(&SampleDecryptor::workerLoop, this, i);
+    }
+}
+
+SampleDecryptor::~SampleDecryptor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    workCv.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool SampleDecryptor::decrypt(const std::array<uint8_t, 16>& key, const std::vector<Job>& jobs) {
+    if (jobs.size() == 0) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    if (workers.size() == 0 || jobs.size() == 1) {
+        if (!contexts[0]->setKey(key)) {
+            return false;
+        }
+        for (const auto& job : jobs) {
+            if (!contexts[0]->decrypt(job.data, job.size, *job.iv)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentKey = key;
+        currentJobs = &jobs;
+        nextJob = 0;
+        failed = false;
+        pendingWorkers = workers.size();
+        ++generation;
+    }
+    workCv.notify_all();
+
+    runJobs(*contexts[0]);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCv.wait(lock, [this] { return pendingWorkers == 0; });
+    currentJobs = nullptr;
+
+    return !failed;
+}
+
+void SampleDecryptor::workerLoop(size_t workerIdx) {
+    uint64_t lastGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workCv.wait(lock, [&] { return stop || generation != lastGeneration; });
+            if (stop) {
+                return;
+            }
+            lastGeneration = generation;
+        }
+
+        runJobs(*contexts[workerIdx]);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --pendingWorkers;
+        }
+        doneCv.notify_one();
+    }
+}
+
+void SampleDecryptor::runJobs(AesCtrContext& ctx) {
+    if (!ctx.setKey(currentKey)) {
+        failed = true;
+        return;
+    }
+
+    const std::vector<Job>& jobs = *currentJobs;
+    while (true) {
+        size_t i = nextJob.fetch_add(1);
+        if (i >= jobs.size()) {
+            break;
+        }
+
+        if (!ctx.decrypt(jobs[i].data, jobs[i].size, *jobs[i].iv)) {
+            failed = true;
+        }
+    }
+}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+
+struct evp_cipher_ctx_st;
+
+namespace atsc3 {
+
+class AesCtrContext {
+public:
+    AesCtrContext();
+    ~AesCtrContext();
+
+    AesCtrContext(const AesCtrContext&) = delete;
+    AesCtrContext& operator=(const AesCtrContext&) = delete;
+
+    bool setKey(const std::array<uint8_t, 16>& key);
+    bool decrypt(uint8_t* data, size_t size, const std::array<uint8_t, 16>& iv);
+
+private:
+    evp_cipher_ctx_st* ctx{ nullptr };
+    std::array<uint8_t, 16> key{};
+    bool hasKey{ false };
+};
+
+class SampleDecryptor {
+public:
+    struct Job {
+        uint8_t* data;
+        size_t size;
+        const std::array<uint8_t, 16>* iv;
+    };
+
+    // One pool serves every MP4Processor, sized by --decryptThreads
+    static SampleDecryptor& instance();
+
+    // threadCount <= 1 decrypts on the calling thread only
+    explicit SampleDecryptor(uint32_t threadCount);
+    ~SampleDecryptor();
+
+    SampleDecryptor(const SampleDecryptor&) = delete;
+    SampleDecryptor& operator=(const SampleDecryptor&) = delete;
+
+    // Decrypts every job in place and returns once all of them are done.
+    // Batches of different callers are run one after another.
+    bool decrypt(const std::array<uint8_t, 16>& key, const std::vector<Job>& jobs);
+
+private:
+    void workerLoop(size_t workerIdx);
+    void runJobs(AesCtrContext& ctx);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<AesCtrContext>> contexts;
+
+    std::mutex batchMutex;
+    std::mutex mutex;
+    std::condition_variable workCv;
+    std::condition_variable doneCv;
+    uint64_t generation{ 0 };
+    size_t pendingWorkers{ 0 };
+    bool stop{ false };
+
+    std::array<uint8_t, 16> currentKey{};
+    const std::vector<Job>* currentJobs{ nullptr };
+    std::atomic<size_t> nextJob{ 0 };
+    std::atomic<bool> failed{ false };
+};
+
+}
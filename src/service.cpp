@@ -1,92 +1,133 @@
-#include "service.h"
-#include <map>
-#include <chrono>
-#include "pugixml.hpp"
-#include "mp4Processor.h"
-#include "rescale.h"
-#include "mediaTransportDemuxer.h"
-#include "demuxer.h"
-
-namespace atsc3 {
-
-Service::Service(DemuxerHandler* handler) : handler(handler), mmtDemuxer(*this), routeDemuxer(*this) {
-    auto streamTableCallback = [this](std::vector<std::reference_wrapper<MediaStream>>& streams) {
-        this->onStreamTable(streams);
-        return true;
-    };
-
-    routeDemuxer.setOnStreamTableCallback(streamTableCallback);
-    mmtDemuxer.setOnStreamTableCallback(streamTableCallback);
-
-
-    auto streamDataCallback = [this](MediaStream& stream, const std::vector<uint8_t>& mfu, const std::vector<uint8_t>& metadata, uint64_t basePts) {
-        this->onMediaData(stream, mfu, metadata, basePts);
-        return true;
-     };
-
-    routeDemuxer.setOnMediaDataCallback(streamDataCallback);
-    mmtDemuxer.setOnMediaDataCallback(streamDataCallback);
-}
-
-bool Service::processPacket(Common::ReadStream& stream) {
-    routeDemuxer.setServiceCategory(serviceCategory);
-    mmtDemuxer.setServiceCategory(serviceCategory);
-
-    if (slsProtocol == 1) {
-        return routeDemuxer.processPacket(stream);
-    }
-    else if (slsProtocol == 2) {
-        return mmtDemuxer.processPacket(stream);
-    }
-    return true;
-}
-
-std::optional<std::reference_wrapper<MediaStream>> Service::findStream(uint32_t transportSessionId) {
-    auto it = mapStream.find(transportSessionId);
-    if (it != mapStream.end()) {
-        return it->second;
-    }
-    return {};
-}
-
-
-bool Service::onStreamTable(const std::vector<std::reference_wrapper<MediaStream>>& streams) {
-    if (handler) {
-        handler->onPmt(*this, streams);
-    }
-    return false;
-}
-
-bool Service::onMediaData(atsc3::MediaStream& stream, const std::vector<uint8_t>& mfu, const std::vector<uint8_t>& metadata, uint64_t basePts) {
-    std::vector<StreamPacket> packets;
-
-    MP4ConfigParser::parse(metadata, stream.mp4CodecConfig);
-
-    std::vector<uint8_t> input;
-    input.insert(input.end(), metadata.begin(), metadata.end());
-    input.insert(input.end(), mfu.begin(), mfu.end());
-
-    mp4Processor.process(input, packets);
-
-    if (packets.size() == 0) {
-        return false;
-    }
-
-    if (basePts != 0) {
-        int64_t rescaled = av_rescale(basePts, stream.mp4CodecConfig.timescale, 1000000ll * 1);
-
-        for (auto& packet : packets) {
-            packet.dts += rescaled;
-            packet.pts += rescaled;
-        }
-    }
-
-    if (handler != nullptr) {
-        handler->onStreamData(*this, stream, packets);
-    }
-
-    return true;
-}
-
-
+#include "service.h"
+#include <map>
+#include <chrono>
+#include <algorithm>
+#include "pugixml.hpp"
+#include "mp4Processor.h"
+#include "rescale.h"
+#include "mediaTransportDemuxer.h"
+#include "demuxer.h"
+
+namespace atsc3 {
+
+Service::Service(DemuxerHandler* handler) : handler(handler), mmtDemuxer(*this), routeDemuxer(*this) {
+    auto streamTableCallback = [this](std::vector<std::reference_wrapper<MediaStream>>& streams) {
+        this->onStreamTable(streams);
+        return true;
+    };
+
+    routeDemuxer.setOnStreamTableCallback(streamTableCallback);
+    mmtDemuxer.setOnStreamTableCallback(streamTableCallback);
+
+
+    auto streamDataCallback = [this](MediaStream& stream, const std::vector<uint8_t>& mfu, const std::vector<uint8_t>& metadata, uint64_t basePts) {
+        this->onMediaData(stream, mfu, metadata, basePts);
+        return true;
+     };
+
+    routeDemuxer.setOnMediaDataCallback(streamDataCallback);
+    mmtDemuxer.setOnMediaDataCallback(streamDataCallback);
+}
+
+bool Service::processPacket(Common::ReadStream& stream) {
+    routeDemuxer.setServiceCategory(serviceCategory);
+    mmtDemuxer.setServiceCategory(serviceCategory);
+
+    if (slsProtocol == 1) {
+        return routeDemuxer.processPacket(stream);
+    }
+    else if (slsProtocol == 2) {
+        return mmtDemuxer.processPacket(stream);
+    }
+    return true;
+}
+
+std::optional<std::reference_wrapper<MediaStream>> Service::findStream(uint32_t transportSessionId) {
+    auto it = mapStream.find(transportSessionId);
+    if (it != mapStream.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+
+bool Service::onStreamTable(const std::vector<std::reference_wrapper<MediaStream>>& streams) {
+    // Drop held segments of streams that are no longer signaled
+    for (auto it = pendingSegments.begin(); it != pendingSegments.end(); ) {
+        auto found = std::find_if(streams.begin(), streams.end(),
+            [&](const auto& stream) { return &stream.get() == &it->stream.get(); });
+        if (found == streams.end()) {
+            it = pendingSegments.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    if (handler) {
+        handler->onPmt(*this, streams);
+    }
+    return false;
+}
+
+bool Service::onMediaData(atsc3::MediaStream& stream, const std::vector<uint8_t>& mfu, const std::vector<uint8_t>& metadata, uint64_t basePts) {
+    std::vector<uint8_t> input;
+    input.insert(input.end(), metadata.begin(), metadata.end());
+    input.insert(input.end(), mfu.begin(), mfu.end());
+
+    PendingSegment pending{ stream, metadata, basePts };
+    if (mp4Processor.parse(input, pending.segment) != MP4ProcessResult::Ok) {
+        return false;
+    }
+
+    if (pendingSegments.size() >= kMaxPendingSegments) {
+        fprintf(stderr, "[CAS] Too many segments waiting for a key, dropping the oldest one (serviceId=%u)\n", serviceId);
+        pendingSegments.pop_front();
+    }
+
+    // Goes out right away unless its key, or the key of a segment before it, is still on the way
+    pendingSegments.push_back(std::move(pending));
+    releasePendingSegments();
+    return true;
+}
+
+void Service::releasePendingSegments() {
+    while (pendingSegments.size() > 0) {
+        PendingSegment& pending = pendingSegments.front();
+        MP4ProcessResult result = mp4Processor.decrypt(pending.segment);
+        if (result == MP4ProcessResult::WaitingForKey) {
+            break;
+        }
+        if (result == MP4ProcessResult::Ok) {
+            deliverSegment(pending);
+        }
+
+        pendingSegments.pop_front();
+    }
+}
+
+void Service::deliverSegment(PendingSegment& pending) {
+    MediaStream& stream = pending.stream;
+    std::vector<StreamPacket>& packets = pending.segment.packets;
+
+    MP4ConfigParser::parse(pending.metadata, stream.mp4CodecConfig);
+
+    if (packets.size() == 0) {
+        return;
+    }
+
+    if (pending.basePts != 0) {
+        int64_t rescaled = av_rescale(pending.basePts, stream.mp4CodecConfig.timescale, 1000000ll * 1);
+
+        for (auto& packet : packets) {
+            packet.dts += rescaled;
+            packet.pts += rescaled;
+        }
+    }
+
+    if (handler != nullptr) {
+        handler->onStreamData(*this, stream, packets);
+    }
+}
+
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
-#pragma once
-#include <vector>
-#include <cstdint>
-
-struct StreamPacket {
-    std::vector<uint8_t> data;
-    uint64_t dts;
-    uint64_t pts;
-};
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+struct StreamPacket {
+    std::vector<uint8_t> data;
+    uint64_t dts;
+    uint64_t pts;
+    // Sync sample flag from the movie fragment, when it was signaled
+    std::optional<bool> keyframe;
+};
@@ -0,0 +1,319 @@
+#include "tsFileWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <malloc.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+namespace {
+
+// Unbuffered I/O needs buffers and sizes that are multiples of the sector size,
+// and 4 KiB covers both 512-byte and Advanced Format sectors
+constexpr size_t alignment = 4096;
+
+size_t alignUp(size_t size) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+}
+
+std::string appendToFileName(const std::string& path, const std::string& suffix) {
+    size_t dot = path.find_last_of('.');
+    size_t separator = path.find_last_of("/\\");
+    if (dot == std::string::npos || (separator != std::string::npos && dot < separator)) {
+        return path + suffix;
+    }
+    return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+TsFileWriter::~TsFileWriter() {
+    close();
+}
+
+bool TsFileWriter::open(const std::string& path, const Options& options) {
+    if (isOpen()) {
+        return false;
+    }
+
+    this->options = options;
+    this->options.blockSize = alignUp(std::max(options.blockSize, alignment));
+    this->options.maxQueuedBlocks = std::max<size_t>(options.maxQueuedBlocks, 1);
+
+    DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+    if (options.direct) {
+        flags |= FILE_FLAG_NO_BUFFERING;
+    }
+
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, flags, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    if (options.preallocateSize > 0) {
+        FILE_ALLOCATION_INFO allocationInfo;
+        allocationInfo.AllocationSize.QuadPart = static_cast<LONGLONG>(options.preallocateSize);
+        if (!SetFileInformationByHandle(handle, FileAllocationInfo, &allocationInfo, sizeof(allocationInfo))) {
+            fprintf(stderr, "[Output] Unable to preallocate %llu bytes\n", static_cast<unsigned long long>(options.preallocateSize));
+        }
+    }
+
+    file = handle;
+    stopping = false;
+    failed = false;
+    stats = Stats();
+    current = allocateBlock();
+    thread = std::thread(&TsFileWriter::worker, this);
+    return true;
+}
+
+void TsFileWriter::write(const uint8_t* data, size_t size) {
+    if (!isOpen()) {
+        return;
+    }
+
+    while (size > 0) {
+        size_t chunkSize = std::min(size, options.blockSize - current.size);
+        memcpy(current.data + current.size, data, chunkSize);
+        current.size += chunkSize;
+        data += chunkSize;
+        size -= chunkSize;
+
+        if (current.size == options.blockSize) {
+            submit(current);
+            current = allocateBlock();
+        }
+    }
+}
+
+bool TsFileWriter::close() {
+    if (!isOpen()) {
+        return true;
+    }
+
+    if (current.size > 0) {
+        submit(current);
+    }
+    else {
+        freeBlock(current);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    blockQueued.notify_one();
+    thread.join();
+
+    Stats result = getStats();
+    // Counts the data only, without the padding of the last block
+    uint64_t fileSize = result.bytesWritten;
+
+    HANDLE handle = static_cast<HANDLE>(file);
+    // The last block was padded for unbuffered I/O and preallocated space lies past the data
+    if (options.direct || options.preallocateSize > 0) {
+        FILE_END_OF_FILE_INFO endOfFileInfo;
+        endOfFileInfo.EndOfFile.QuadPart = static_cast<LONGLONG>(fileSize);
+        SetFileInformationByHandle(handle, FileEndOfFileInfo, &endOfFileInfo, sizeof(endOfFileInfo));
+    }
+    CloseHandle(handle);
+    file = nullptr;
+
+    for (auto& block : freeBlocks) {
+        _aligned_free(block.data);
+    }
+    freeBlocks.clear();
+
+    fprintf(stderr, "[Output] %llu bytes in %llu writes, write latency avg %.1f ms / max %.1f ms, max queue depth %zu, %llu stalls\n",
+        static_cast<unsigned long long>(fileSize),
+        static_cast<unsigned long long>(result.blocksWritten),
+        result.blocksWritten ? result.totalWriteTime.count() / 1000.0 / result.blocksWritten : 0.0,
+        result.maxWriteTime.count() / 1000.0,
+        result.maxQueueDepth,
+        static_cast<unsigned long long>(result.stalls));
+
+    return !failed;
+}
+
+TsFileWriter::Stats TsFileWriter::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+TsFileWriter::Block TsFileWriter::allocateBlock() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeBlocks.size() > 0) {
+            Block block = freeBlocks.back();
+            freeBlocks.pop_back();
+            return block;
+        }
+    }
+
+    Block block;
+    block.data = static_cast<uint8_t*>(_aligned_malloc(options.blockSize, alignment));
+    return block;
+}
+
+void TsFileWriter::freeBlock(Block& block) {
+    std::lock_guard<std::mutex> lock(mutex);
+    block.size = 0;
+    freeBlocks.push_back(block);
+    block = Block();
+}
+
+void TsFileWriter::submit(Block& block) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (queue.size() >= options.maxQueuedBlocks) {
+            if (stats.stalls == 0) {
+                fprintf(stderr, "[Output] Writer queue is full, waiting for the disk\n");
+            }
+            ++stats.stalls;
+            blockWritten.wait(lock, [this]() { return queue.size() < options.maxQueuedBlocks; });
+        }
+
+        queue.push_back(block);
+        stats.maxQueueDepth = std::max(stats.maxQueueDepth, queue.size());
+    }
+    blockQueued.notify_one();
+    block = Block();
+}
+
+void TsFileWriter::worker() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        blockQueued.wait(lock, [this]() { return stopping || queue.size() > 0; });
+        if (queue.size() == 0) {
+            return;
+        }
+
+        Block block = queue.front();
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        bool result = writeBlock(block);
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        lock.lock();
+        // Popped only once written so that the queue depth covers the block in flight
+        queue.pop_front();
+        if (!result && !failed) {
+            fprintf(stderr, "[Output] Write failed (error %lu)\n", GetLastError());
+            failed = true;
+        }
+        stats.bytesWritten += block.size;
+        ++stats.blocksWritten;
+        stats.totalWriteTime += elapsed;
+        stats.maxWriteTime = std::max(stats.maxWriteTime, elapsed);
+
+        block.size = 0;
+        freeBlocks.push_back(block);
+        blockWritten.notify_one();
+    }
+}
+
+bool TsFileWriter::writeBlock(const Block& block) {
+    size_t size = block.size;
+    if (options.direct) {
+        // Padding past the data is cut off again when the file is closed
+        size_t alignedSize = alignUp(size);
+        memset(block.data + size, 0, alignedSize - size);
+        size = alignedSize;
+    }
+
+    DWORD written = 0;
+    return WriteFile(static_cast<HANDLE>(file), block.data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+}
+
+bool RotatingTsFileWriter::open(const std::string& path, const TsFileWriter::Options& options, uint64_t maxDuration, uint64_t maxSize) {
+    this->path = path;
+    this->options = options;
+    this->maxDuration = maxDuration;
+    this->maxSize = maxSize;
+    segmentIndex = 0;
+    failed = false;
+    return openSegment();
+}
+
+void RotatingTsFileWriter::write(const uint8_t* data, size_t size) {
+    writer->write(data, size);
+    segmentSize += size;
+}
+
+bool RotatingTsFileWriter::rotateIfDue(uint64_t dts) {
+    if (maxDuration == 0 && maxSize == 0) {
+        return false;
+    }
+
+    // A DTS going backwards is a discontinuity and restarts the duration
+    if (!hasSegmentStartDts || dts < segmentStartDts) {
+        segmentStartDts = dts;
+        hasSegmentStartDts = true;
+        return false;
+    }
+
+    bool due = (maxDuration != 0 && dts - segmentStartDts >= maxDuration) || (maxSize != 0 && segmentSize >= maxSize);
+    if (!due) {
+        return false;
+    }
+
+    // Closing waits until everything queued for the file is on disk, so it is left to another thread
+    // and the next file is opened right away. Only a rotation that comes before the previous file
+    // is closed has to wait for it.
+    finishClosing();
+    std::unique_ptr<TsFileWriter> previous = std::move(writer);
+    ++segmentIndex;
+    if (!openSegment()) {
+        failed = true;
+    }
+    closing = std::async(std::launch::async, [previous = std::move(previous)]() {
+        return previous->close();
+    });
+    segmentStartDts = dts;
+    return true;
+}
+
+bool RotatingTsFileWriter::close() {
+    finishClosing();
+    if (!writer->close()) {
+        failed = true;
+    }
+    return !failed;
+}
+
+void RotatingTsFileWriter::finishClosing() {
+    if (closing.valid() && !closing.get()) {
+        failed = true;
+    }
+}
+
+std::string RotatingTsFileWriter::getSegmentPath() const {
+    if (maxDuration == 0 && maxSize == 0) {
+        return path;
+    }
+
+    char index[16];
+    snprintf(index, sizeof(index), "_%05u", segmentIndex);
+    return appendToFileName(path, index);
+}
+
+bool RotatingTsFileWriter::openSegment() {
+    segmentSize = 0;
+    if (!writer) {
+        writer = std::make_unique<TsFileWriter>();
+    }
+
+    std::string segmentPath = getSegmentPath();
+    if (!writer->open(segmentPath, options)) {
+        fprintf(stderr, "[Output] Unable to open %s\n", segmentPath.c_str());
+        return false;
+    }
+    if (segmentIndex > 0) {
+        fprintf(stderr, "[Output] Continuing in %s\n", segmentPath.c_str());
+    }
+    return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <future>
+
+// Writes the TS output from a thread of its own, so a slow disk does not stall demuxing.
+// Packets are collected into large blocks aligned for unbuffered I/O, and each block is
+// written with a single call.
+class TsFileWriter {
+public:
+    struct Options {
+        size_t blockSize{ 2 * 1024 * 1024 };
+        // Bypasses the system cache (FILE_FLAG_NO_BUFFERING)
+        bool direct{ false };
+        // Space reserved up front to keep the file from fragmenting
+        uint64_t preallocateSize{ 0 };
+        size_t maxQueuedBlocks{ 8 };
+    };
+
+    struct Stats {
+        uint64_t bytesWritten{ 0 };
+        uint64_t blocksWritten{ 0 };
+        size_t maxQueueDepth{ 0 };
+        // Times write() had to wait because the queue was full
+        uint64_t stalls{ 0 };
+        std::chrono::microseconds totalWriteTime{ 0 };
+        std::chrono::microseconds maxWriteTime{ 0 };
+    };
+
+    TsFileWriter() = default;
+    ~TsFileWriter();
+
+    TsFileWriter(const TsFileWriter&) = delete;
+    TsFileWriter& operator=(const TsFileWriter&) = delete;
+
+    bool open(const std::string& path, const Options& options);
+    void write(const uint8_t* data, size_t size);
+    // Writes what is left, waits for the thread and closes the file. Returns false if any write failed.
+    bool close();
+
+    bool isOpen() const {
+        return file != nullptr;
+    }
+
+    Stats getStats();
+
+private:
+    struct Block {
+        uint8_t* data{ nullptr };
+        size_t size{ 0 };
+    };
+
+    Block allocateBlock();
+    void freeBlock(Block& block);
+    void submit(Block& block);
+    void worker();
+    bool writeBlock(const Block& block);
+
+    // HANDLE of the file; kept opaque to stay clear of windows.h here
+    void* file{ nullptr };
+    Options options;
+    Block current;
+
+    std::mutex mutex;
+    std::condition_variable blockQueued;
+    std::condition_variable blockWritten;
+    std::deque<Block> queue;
+    std::vector<Block> freeBlocks;
+    bool stopping{ false };
+    bool failed{ false };
+    Stats stats;
+    std::thread thread;
+
+};
+
+// Puts the suffix between the file name and its extension
+std::string appendToFileName(const std::string& path, const std::string& suffix);
+
+// Starts a new file once the current one has reached a duration or a size. The caller decides
+// where a file may end; the rotation only happens when it asks for it at such a point.
+// Files are named after the given path with a sequence number in front of the extension.
+// A file that has been rotated out is written out and closed in the background.
+// Times are in 90 kHz units.
+class RotatingTsFileWriter {
+public:
+    // Without a duration and a size, everything goes into the given path
+    bool open(const std::string& path, const TsFileWriter::Options& options, uint64_t maxDuration, uint64_t maxSize);
+    void write(const uint8_t* data, size_t size);
+    // Returns true when the file has been rotated and the data from here on goes into a new file
+    bool rotateIfDue(uint64_t dts);
+    bool close();
+
+private:
+    std::string getSegmentPath() const;
+    bool openSegment();
+    // Waits for the previous file to be closed
+    void finishClosing();
+
+    std::unique_ptr<TsFileWriter> writer{ std::make_unique<TsFileWriter>() };
+    std::future<bool> closing;
+    TsFileWriter::Options options;
+    std::string path;
+    uint64_t maxDuration{ 0 };
+    uint64_t maxSize{ 0 };
+    uint32_t segmentIndex{ 0 };
+    uint64_t segmentSize{ 0 };
+    uint64_t segmentStartDts{ 0 };
+    bool hasSegmentStartDts{ false };
+    bool failed{ false };
+
+};
@@ -0,0 +1,183 @@
+#include "tsHttpServer.h"
+#include <algorithm>
+#include <cstdio>
+#include <chrono>
+#include "httplib.h"
+
+TsHttpServer::TsHttpServer() = default;
+
+TsHttpServer::~TsHttpServer() {
+    stop();
+}
+
+bool TsHttpServer::start(const std::string& host, int port, const Options& options) {
+    if (server) {
+        return false;
+    }
+
+    this->options = options;
+    stopping = false;
+    server = std::make_unique<httplib::Server>();
+
+    // Every client keeps a thread busy for as long as it is connected
+    size_t threadCount = options.maxClients + 1;
+    server->new_task_queue = [threadCount]() {
+        return new httplib::ThreadPool(threadCount);
+    };
+
+    auto serve = [this](uint32_t stream, const httplib::Request& req, httplib::Response& res) {
+        auto client = std::make_shared<Client>();
+        client->stream = stream;
+        client->address = req.remote_addr + ":" + std::to_string(req.remote_port);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stream != mptsStream && services.count(stream) == 0) {
+                res.status = 404;
+                return;
+            }
+            if (stopping || clientCount >= this->options.maxClients) {
+                res.status = 503;
+                return;
+            }
+            addClient(client);
+        }
+        fprintf(stderr, "[HTTP] %s connected to %s\n", client->address.c_str(), req.path.c_str());
+
+        res.set_header("Cache-Control", "no-cache");
+        res.set_chunked_content_provider("video/mp2t", [this, client](size_t offset, httplib::DataSink& sink) {
+            Chunk chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // Wakes up now and then so that a closed connection is noticed without new data
+                chunkQueued.wait_for(lock, std::chrono::seconds(1), [&]() {
+                    return client->dropped || stopping || client->queue.size() > 0;
+                });
+                if (client->dropped) {
+                    return false;
+                }
+                if (client->queue.size() == 0) {
+                    if (stopping) {
+                        lock.unlock();
+                        sink.done();
+                    }
+                    return true;
+                }
+
+                chunk = std::move(client->queue.front());
+                client->queue.pop_front();
+            }
+            return sink.write(reinterpret_cast<const char*>(chunk->data()), chunk->size());
+        }, [this, client](bool success) {
+            removeClient(client);
+        });
+    };
+
+    server->Get("/", [serve](const httplib::Request& req, httplib::Response& res) {
+        serve(mptsStream, req, res);
+    });
+    server->Get(R"(/service/(\d{1,5}))", [serve](const httplib::Request& req, httplib::Response& res) {
+        serve(static_cast<uint32_t>(std::stoul(req.matches[1])), req, res);
+    });
+
+    if (!server->bind_to_port(host, port)) {
+        server.reset();
+        return false;
+    }
+    thread = std::thread([this]() {
+        server->listen_after_bind();
+    });
+
+    fprintf(stderr, "[HTTP] Serving on %s:%d\n", host.c_str(), port);
+    return true;
+}
+
+void TsHttpServer::stop() {
+    if (!server) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (auto& [id, stream] : mapStream) {
+            publish(stream);
+        }
+        stopping = true;
+        chunkQueued.notify_all();
+
+        // Gives the clients some time to take the rest of their queue
+        clientRemoved.wait_for(lock, std::chrono::seconds(5), [this]() { return clientCount == 0; });
+    }
+
+    server->stop();
+    thread.join();
+    server.reset();
+    mapStream.clear();
+}
+
+void TsHttpServer::write(uint32_t stream, const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = mapStream.find(stream);
+    if (it == mapStream.end() || it->second.clients.size() == 0) {
+        return;
+    }
+
+    Stream& target = it->second;
+    target.pending.insert(target.pending.end(), data, data + size);
+    if (target.pending.size() >= options.chunkSize) {
+        publish(target);
+    }
+}
+
+void TsHttpServer::setServices(const std::vector<uint32_t>& serviceIds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    services = std::unordered_set<uint32_t>(serviceIds.begin(), serviceIds.end());
+}
+
+void TsHttpServer::publish(Stream& stream) {
+    if (stream.pending.size() == 0) {
+        return;
+    }
+
+    Chunk chunk = std::make_shared<const std::vector<uint8_t>>(std::move(stream.pending));
+    stream.pending = std::vector<uint8_t>();
+    stream.pending.reserve(options.chunkSize);
+
+    for (auto& client : stream.clients) {
+        if (client->dropped) {
+            continue;
+        }
+        if (client->queue.size() >= options.maxQueuedChunks) {
+            fprintf(stderr, "[HTTP] %s fell behind, disconnecting\n", client->address.c_str());
+            client->dropped = true;
+            client->queue.clear();
+            continue;
+        }
+        client->queue.push_back(chunk);
+    }
+    chunkQueued.notify_all();
+}
+
+void TsHttpServer::addClient(const std::shared_ptr<Client>& client) {
+    mapStream[client->stream].clients.push_back(client);
+    ++clientCount;
+}
+
+void TsHttpServer::removeClient(const std::shared_ptr<Client>& client) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = mapStream.find(client->stream);
+        if (it != mapStream.end()) {
+            auto& clients = it->second.clients;
+            clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+            if (clients.size() == 0) {
+                // A client that connects later starts with fresh data
+                it->second.pending.clear();
+            }
+        }
+        --clientCount;
+    }
+    clientRemoved.notify_all();
+
+    fprintf(stderr, "[HTTP] %s disconnected\n", client->address.c_str());
+}
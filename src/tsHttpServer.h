@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace httplib {
+class Server;
+}
+
+// Serves the live TS to HTTP clients with chunked transfer: the MPTS on /, and the SPTS of a
+// service on /service/<serviceId>. The output is collected into chunks that are shared by every
+// client of a stream. Each client has a bounded queue of them, and a client whose queue is full
+// has fallen behind and is disconnected, so it never holds back the others.
+class TsHttpServer {
+public:
+    static constexpr uint32_t mptsStream = UINT32_MAX;
+
+    struct Options {
+        size_t chunkSize{ 188 * 348 };
+        size_t maxQueuedChunks{ 64 };
+        size_t maxClients{ 16 };
+    };
+
+    TsHttpServer();
+    ~TsHttpServer();
+
+    TsHttpServer(const TsHttpServer&) = delete;
+    TsHttpServer& operator=(const TsHttpServer&) = delete;
+
+    bool start(const std::string& host, int port, const Options& options);
+    // Sends what is collected so far, lets the clients take what is queued for them and stops the server
+    void stop();
+
+    // The stream is a service ID, or mptsStream
+    void write(uint32_t stream, const uint8_t* data, size_t size);
+    // The services that can be asked for; any other service ID is answered with 404
+    void setServices(const std::vector<uint32_t>& serviceIds);
+
+private:
+    using Chunk = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Client {
+        uint32_t stream{ 0 };
+        std::string address;
+        std::deque<Chunk> queue;
+        bool dropped{ false };
+    };
+
+    struct Stream {
+        std::vector<uint8_t> pending;
+        std::vector<std::shared_ptr<Client>> clients;
+    };
+
+    void publish(Stream& stream);
+    void addClient(const std::shared_ptr<Client>& client);
+    void removeClient(const std::shared_ptr<Client>& client);
+
+    std::unique_ptr<httplib::Server> server;
+    std::thread thread;
+    Options options;
+
+    std::mutex mutex;
+    std::condition_variable chunkQueued;
+    std::condition_variable clientRemoved;
+    std::unordered_map<uint32_t, Stream> mapStream;
+    std::unordered_set<uint32_t> services;
+    size_t clientCount{ 0 };
+    bool stopping{ false };
+
+};
@@ -0,0 +1,94 @@
+#include "tsInterleaver.h"
+
+namespace {
+
+// Enough to keep the buffers of a few seconds of output around
+constexpr size_t maxPoolSize = 1024;
+// A hold this far behind the newest entry belongs to a PID that has stopped, and no longer holds
+constexpr uint64_t maxHoldLag = 10 * 90000;
+
+}
+
+std::vector<uint8_t> TsInterleaver::acquire() {
+    if (pool.size() == 0) {
+        return {};
+    }
+
+    std::vector<uint8_t> buffer = std::move(pool.back());
+    pool.pop_back();
+    return buffer;
+}
+
+void TsInterleaver::release(std::vector<uint8_t>&& buffer) {
+    if (pool.size() >= maxPoolSize) {
+        return;
+    }
+
+    buffer.clear();
+    pool.push_back(std::move(buffer));
+}
+
+void TsInterleaver::hold(uint16_t pid, uint64_t dts) {
+    auto it = mapHold.find(pid);
+    if (it == mapHold.end() || dts < it->second) {
+        mapHold[pid] = dts;
+    }
+}
+
+void TsInterleaver::clearHolds() {
+    mapHold.clear();
+}
+
+void TsInterleaver::push(uint16_t pid, uint32_t serviceIdx, uint64_t dts, bool randomAccess, std::vector<uint8_t>&& packets) {
+    // The PES of one PID must stay in order, so a small step back in DTS is ordered after
+    // what is already queued. A large one starts a new timeline.
+    uint64_t key = dts;
+    auto it = mapLastKey.find(pid);
+    if (it != mapLastKey.end() && key < it->second) {
+        if (it->second - key <= window) {
+            key = it->second;
+        }
+        else {
+            ++epoch;
+            maxKey = key;
+        }
+    }
+    mapLastKey[pid] = key;
+
+    if (key > maxKey) {
+        maxKey = key;
+    }
+
+    Item item;
+    item.epoch = epoch;
+    item.key = key;
+    item.sequence = sequence++;
+    item.entry.dts = dts;
+    item.entry.serviceIdx = serviceIdx;
+    item.entry.randomAccess = randomAccess;
+    item.entry.packets = std::move(packets);
+    queue.push(std::move(item));
+}
+
+bool TsInterleaver::pop(Entry& entry, bool flush) {
+    if (queue.size() == 0) {
+        return false;
+    }
+
+    const Item& item = queue.top();
+    if (!flush && item.epoch == epoch) {
+        if (item.key + window > maxKey) {
+            return false;
+        }
+        for (const auto& [pid, dts] : mapHold) {
+            if (item.key >= dts && dts + maxHoldLag > maxKey) {
+                return false;
+            }
+        }
+    }
+
+    // priority_queue only gives const access to the top
+    entry = std::move(const_cast<Item&>(item).entry);
+    queue.pop();
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <functional>
+
+// Holds packetized PES back for a time window and hands them out in DTS order across PIDs,
+// so that audio and video which arrive in bursts of whole segments end up interleaved.
+// The packet buffers are recycled. Times are in 90 kHz units.
+class TsInterleaver {
+public:
+    struct Entry {
+        uint64_t dts{ 0 };
+        uint32_t serviceIdx{ 0 };
+        // Starts with a video random access point
+        bool randomAccess{ false };
+        std::vector<uint8_t> packets;
+    };
+
+    void setWindow(uint64_t window) {
+        this->window = window;
+    }
+
+    // An empty buffer to packetize into, taken from the recycled ones if possible
+    std::vector<uint8_t> acquire();
+    void release(std::vector<uint8_t>&& buffer);
+
+    // A PID that still has data on the way which is not pushed yet, such as audio being transcoded,
+    // holds back every entry from that DTS on, however far the other PIDs have moved ahead
+    void hold(uint16_t pid, uint64_t dts);
+    void clearHolds();
+
+    void push(uint16_t pid, uint32_t serviceIdx, uint64_t dts, bool randomAccess, std::vector<uint8_t>&& packets);
+
+    // Takes the entry with the lowest DTS once it has fallen out of the window, or any entry when flushing
+    bool pop(Entry& entry, bool flush);
+
+    size_t size() const {
+        return queue.size();
+    }
+
+private:
+    struct Item {
+        uint32_t epoch;
+        uint64_t key;
+        uint64_t sequence;
+        Entry entry;
+
+        bool operator>(const Item& other) const {
+            if (epoch != other.epoch) {
+                return epoch > other.epoch;
+            }
+            return key != other.key ? key > other.key : sequence > other.sequence;
+        }
+    };
+
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    std::vector<std::vector<uint8_t>> pool;
+    std::unordered_map<uint16_t, uint64_t> mapLastKey;
+    std::unordered_map<uint16_t, uint64_t> mapHold;
+    uint64_t window{ 0 };
+    // Bumped when DTS jumps back by more than the window, which releases everything queued before
+    uint32_t epoch{ 0 };
+    uint64_t maxKey{ 0 };
+    uint64_t sequence{ 0 };
+
+};
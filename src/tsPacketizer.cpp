@@ -0,0 +1,59 @@
+#include "tsPacketizer.h"
+
+void TsPacketizer::writePcr(uint16_t pid, uint64_t pcr, std::vector<uint8_t>& output) {
+    size_t offset = output.size();
+    output.resize(offset + packetSize);
+    uint8_t* p = output.data() + offset;
+
+    writeHeader(p, pid, false, true, false, 0);
+    writeAdaptationField(p + headerSize, maxPayloadSize, pcr, false);
+}
+
+void TsPacketizer::stampContinuityCounters(uint8_t* data, size_t size) {
+    for (uint8_t* p = data; p + packetSize <= data + size; p += packetSize) {
+        uint16_t pid = ((p[1] & 0x1F) << 8) | p[2];
+        uint8_t& counter = cc[pid];
+        if (p[3] & 0x10) {
+            p[3] = (p[3] & 0xF0) | (counter++ & 0xF);
+        }
+        else {
+            // Without payload the continuity counter stays at that of the previous packet
+            p[3] = (p[3] & 0xF0) | ((counter - 1) & 0xF);
+        }
+    }
+}
+
+void TsPacketizer::writeHeader(uint8_t* packet, uint16_t pid, bool payloadUnitStart, bool hasAdaptationField, bool hasPayload, uint8_t cc) {
+    packet[0] = 0x47;
+    packet[1] = (payloadUnitStart ? 0x40 : 0) | ((pid >> 8) & 0x1F);
+    packet[2] = pid & 0xFF;
+    packet[3] = (hasAdaptationField ? 0x20 : 0) | (hasPayload ? 0x10 : 0) | (cc & 0xF);
+}
+
+void TsPacketizer::writeAdaptationField(uint8_t* output, size_t size, uint64_t pcr, bool randomAccess) {
+    if (size == 0) {
+        return;
+    }
+
+    // adaptation_field_length
+    output[0] = static_cast<uint8_t>(size - 1);
+    if (size == 1) {
+        return;
+    }
+
+    output[1] = (randomAccess ? 0x40 : 0) | (pcr != noPcr ? 0x10 : 0);
+    size_t pos = 2;
+    if (pcr != noPcr) {
+        uint64_t base = pcr / 300;
+        uint64_t extension = pcr % 300;
+        output[2] = static_cast<uint8_t>(base >> 25);
+        output[3] = static_cast<uint8_t>(base >> 17);
+        output[4] = static_cast<uint8_t>(base >> 9);
+        output[5] = static_cast<uint8_t>(base >> 1);
+        output[6] = static_cast<uint8_t>(((base & 1) << 7) | 0x7E | (extension >> 8));
+        output[7] = static_cast<uint8_t>(extension);
+        pos = 8;
+    }
+
+    memset(output + pos, 0xFF, size - pos);
+}
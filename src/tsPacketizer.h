@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "pesPacket.h"
+
+// Writes PES packets straight into 188-byte TS packets appended to an output buffer,
+// so each payload byte is copied once. Packets are written with a zero continuity counter;
+// the counters of all PIDs are kept here and filled in once the output order is known.
+class TsPacketizer {
+public:
+    static constexpr size_t packetSize = 188;
+    static constexpr uint64_t noPcr = UINT64_MAX;
+
+    // Sets the continuity counters of whole packets in the order they are sent
+    void stampContinuityCounters(uint8_t* data, size_t size);
+
+    // pcrFor(index, count) returns the PCR to put in the packet at index, or noPcr.
+    // count is the number of packets the PES takes without any PCR.
+    template <typename PcrFor>
+    void writePes(uint16_t pid, const PESPacket& pes, const std::vector<PesChunk>& payload, bool randomAccess, PcrFor&& pcrFor, std::vector<uint8_t>& output);
+
+    void writePes(uint16_t pid, const PESPacket& pes, const std::vector<PesChunk>& payload, std::vector<uint8_t>& output) {
+        writePes(pid, pes, payload, false, [](size_t, size_t) { return noPcr; }, output);
+    }
+
+    // A packet with nothing but a PCR in its adaptation field
+    void writePcr(uint16_t pid, uint64_t pcr, std::vector<uint8_t>& output);
+
+private:
+    static constexpr size_t headerSize = 4;
+    static constexpr size_t maxPayloadSize = packetSize - headerSize;
+
+    static void writeHeader(uint8_t* packet, uint16_t pid, bool payloadUnitStart, bool hasAdaptationField, bool hasPayload, uint8_t cc);
+    // Fills size bytes with an adaptation field, padding it with stuffing bytes
+    static void writeAdaptationField(uint8_t* output, size_t size, uint64_t pcr, bool randomAccess);
+
+    std::array<uint8_t, 0x2000> cc{};
+
+};
+
+template <typename PcrFor>
+void TsPacketizer::writePes(uint16_t pid, const PESPacket& pes, const std::vector<PesChunk>& payload, bool randomAccess, PcrFor&& pcrFor, std::vector<uint8_t>& output) {
+    size_t payloadSize = 0;
+    for (const auto& chunk : payload) {
+        payloadSize += chunk.size;
+    }
+
+    uint8_t header[PESPacket::maxHeaderSize];
+    size_t pesHeaderSize = pes.writeHeader(payloadSize, header);
+
+    size_t remaining = pesHeaderSize + payloadSize;
+    size_t count = (remaining + maxPayloadSize - 1) / maxPayloadSize;
+
+    // Room for a PCR in every packet; the unused tail is cut off at the end
+    constexpr size_t minPayloadSize = maxPayloadSize - 8;
+    size_t offset = output.size();
+    output.resize(offset + ((remaining + minPayloadSize - 1) / minPayloadSize) * packetSize);
+
+    size_t headerOffset = 0;
+    size_t chunkIndex = 0;
+    size_t chunkOffset = 0;
+    auto copyPayload = [&](uint8_t* p, size_t size) {
+        size_t n = std::min(size, pesHeaderSize - headerOffset);
+        memcpy(p, header + headerOffset, n);
+        headerOffset += n;
+        p += n;
+        size -= n;
+
+        while (size > 0) {
+            const PesChunk& chunk = payload[chunkIndex];
+            n = std::min(size, chunk.size - chunkOffset);
+            memcpy(p, chunk.data + chunkOffset, n);
+            chunkOffset += n;
+            p += n;
+            size -= n;
+
+            if (chunkOffset == chunk.size) {
+                ++chunkIndex;
+                chunkOffset = 0;
+            }
+        }
+    };
+
+    uint8_t* p = output.data() + offset;
+    size_t i = 0;
+    while (remaining > 0) {
+        uint64_t pcr = pcrFor(i, count);
+        bool randomAccessIndicator = i == 0 && randomAccess;
+
+        size_t adaptationFieldSize = pcr != noPcr ? 8 : randomAccessIndicator ? 2 : 0;
+        size_t chunkSize = std::min(remaining, maxPayloadSize - adaptationFieldSize);
+        // The last packet is filled up by stuffing in the adaptation field
+        adaptationFieldSize = maxPayloadSize - chunkSize;
+
+        writeHeader(p, pid, i == 0, adaptationFieldSize > 0, true, 0);
+        writeAdaptationField(p + headerSize, adaptationFieldSize, pcr, randomAccessIndicator);
+        copyPayload(p + headerSize + adaptationFieldSize, chunkSize);
+
+        remaining -= chunkSize;
+        p += packetSize;
+        ++i;
+    }
+
+    output.resize(offset + i * packetSize);
+}
@@ -0,0 +1,362 @@
+#include "tsUdpSender.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+#else
+using NativeSocket = int;
+#endif
+
+// PCR wraps around with its 33-bit base
+constexpr uint64_t pcrWrap = (1ULL << 33) * 300;
+// A larger step between two PCRs is a discontinuity, which is sent on without a pause
+constexpr uint64_t maxPcrGap = 27000000;
+// Sending later than this restarts the clock instead of rushing to catch up
+constexpr auto maxLag = std::chrono::seconds(1);
+constexpr uint8_t rtpPayloadTypeMp2t = 33;
+
+void closeSocket(intptr_t socket) {
+#ifdef _WIN32
+    closesocket(static_cast<NativeSocket>(socket));
+#else
+    ::close(static_cast<NativeSocket>(socket));
+#endif
+}
+
+}
+
+TsUdpSender::TsUdpSender() = default;
+
+TsUdpSender::~TsUdpSender() {
+    close();
+}
+
+bool TsUdpSender::open(const std::string& host, uint16_t port, const Options& options) {
+    if (socket != -1) {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        return false;
+    }
+#endif
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr) {
+        fprintf(stderr, "[UDP] Unable to resolve %s\n", host.c_str());
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    intptr_t s = static_cast<intptr_t>(::socket(result->ai_family, result->ai_socktype, result->ai_protocol));
+    if (s == -1) {
+        freeaddrinfo(result);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    NativeSocket native = static_cast<NativeSocket>(s);
+    int ttl = options.ttl;
+    if (result->ai_family == AF_INET) {
+        const sockaddr_in* addr = reinterpret_cast<const sockaddr_in*>(result->ai_addr);
+        if ((ntohl(addr->sin_addr.s_addr) & 0xF0000000) == 0xE0000000) {
+            setsockopt(native, IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<const char*>(&ttl), sizeof(ttl));
+        }
+    }
+    else if (result->ai_family == AF_INET6) {
+        const sockaddr_in6* addr = reinterpret_cast<const sockaddr_in6*>(result->ai_addr);
+        if (addr->sin6_addr.s6_addr[0] == 0xFF) {
+            setsockopt(native, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, reinterpret_cast<const char*>(&ttl), sizeof(ttl));
+        }
+    }
+
+    // Room for a whole batch and then some
+    int sendBufferSize = 4 * 1024 * 1024;
+    setsockopt(native, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&sendBufferSize), sizeof(sendBufferSize));
+
+    const uint8_t* addressBegin = reinterpret_cast<const uint8_t*>(result->ai_addr);
+    address.assign(addressBegin, addressBegin + result->ai_addrlen);
+    freeaddrinfo(result);
+
+    this->options = options;
+    this->options.maxBatchSize = std::max<size_t>(options.maxBatchSize, 1);
+    this->options.maxQueuedDatagrams = std::max<size_t>(options.maxQueuedDatagrams, 1);
+    socket = s;
+    current = Datagram();
+    pcrPid = 0x1fff;
+    stopping = false;
+    hasLastPcr = false;
+    segmentLength = 0;
+    rtpSequence = 0;
+    rtpSsrc = std::random_device()();
+    startTime = Clock::now();
+    datagramsSent = 0;
+    sendErrors = 0;
+    maxQueueDepth = 0;
+    thread = std::thread(&TsUdpSender::worker, this);
+
+    fprintf(stderr, "[UDP] Sending %s to %s:%u\n", options.rtp ? "RTP" : "UDP", host.c_str(), port);
+    return true;
+}
+
+void TsUdpSender::write(const uint8_t* data, size_t size) {
+    if (socket == -1) {
+        return;
+    }
+
+    for (size_t offset = 0; offset + tsPacketSize <= size; offset += tsPacketSize) {
+        const uint8_t* packet = data + offset;
+
+        // adaptation_field_control with an adaptation field that is long enough and has PCR_flag set
+        if ((packet[3] & 0x20) && packet[4] >= 7 && (packet[5] & 0x10)) {
+            uint16_t pid = ((packet[1] & 0x1F) << 8) | packet[2];
+            if (pcrPid == 0x1fff) {
+                pcrPid = pid;
+            }
+            if (pid == pcrPid && !current.hasPcr) {
+                uint64_t base = (static_cast<uint64_t>(packet[6]) << 25) | (packet[7] << 17) | (packet[8] << 9) | (packet[9] << 1) | (packet[10] >> 7);
+                uint64_t extension = ((packet[10] & 0x01) << 8) | packet[11];
+                current.hasPcr = true;
+                current.pcr = base * 300 + extension;
+            }
+        }
+
+        memcpy(current.data.data() + rtpHeaderSize + current.packetCount * tsPacketSize, packet, tsPacketSize);
+        if (++current.packetCount == packetsPerDatagram) {
+            submit();
+        }
+    }
+}
+
+void TsUdpSender::close() {
+    if (socket == -1) {
+        return;
+    }
+
+    if (current.packetCount > 0) {
+        submit();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    datagramQueued.notify_one();
+    thread.join();
+
+    closeSocket(socket);
+    socket = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    fprintf(stderr, "[UDP] %llu datagrams sent, %llu send errors, max queue depth %zu\n",
+        static_cast<unsigned long long>(datagramsSent),
+        static_cast<unsigned long long>(sendErrors),
+        maxQueueDepth);
+}
+
+void TsUdpSender::submit() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        datagramSent.wait(lock, [this]() { return queue.size() < options.maxQueuedDatagrams; });
+        queue.push_back(current);
+        maxQueueDepth = std::max(maxQueueDepth, queue.size());
+    }
+    datagramQueued.notify_one();
+
+    current.packetCount = 0;
+    current.hasPcr = false;
+}
+
+void TsUdpSender::worker() {
+    std::vector<Datagram> batch;
+    std::vector<Clock::time_point> sendTimes;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        // Takes datagrams while they are due, and the first one that is not
+        Clock::time_point now = Clock::now();
+        while (batch.size() < options.maxBatchSize && queue.size() > 0 && (sendTimes.size() == 0 || sendTimes.back() <= now)) {
+            Clock::time_point sendTime;
+            if (!scheduleFront(now, sendTime)) {
+                break;
+            }
+            batch.push_back(std::move(queue.front()));
+            queue.pop_front();
+            sendTimes.push_back(sendTime);
+        }
+
+        if (batch.size() == 0) {
+            if (stopping && queue.size() == 0) {
+                return;
+            }
+            // Waits for data, or for the next PCR to know how to spread what is queued
+            size_t queueSize = queue.size();
+            datagramQueued.wait(lock, [&]() { return stopping || queue.size() != queueSize; });
+            continue;
+        }
+
+        size_t dueCount = std::upper_bound(sendTimes.begin(), sendTimes.end(), now) - sendTimes.begin();
+        lock.unlock();
+        if (dueCount == 0) {
+            std::this_thread::sleep_until(sendTimes.front());
+        }
+        else {
+            sendBatch(batch, std::vector<Clock::time_point>(sendTimes.begin(), sendTimes.begin() + dueCount));
+            batch.erase(batch.begin(), batch.begin() + dueCount);
+            sendTimes.erase(sendTimes.begin(), sendTimes.begin() + dueCount);
+            datagramSent.notify_one();
+        }
+        lock.lock();
+    }
+}
+
+bool TsUdpSender::scheduleFront(Clock::time_point now, Clock::time_point& sendTime) {
+    const Datagram& front = queue.front();
+
+    if (front.hasPcr) {
+        lastPcrTime = hasLastPcr ? getPcrTime(front.pcr) : now;
+        lastPcr = front.pcr;
+        hasLastPcr = true;
+        segmentLength = 0;
+        sendTime = lastPcrTime;
+    }
+    else if (!hasLastPcr) {
+        // Nothing to pace by before the first PCR
+        sendTime = now;
+    }
+    else {
+        if (segmentLength == 0) {
+            auto next = std::find_if(queue.begin(), queue.end(), [](const Datagram& datagram) { return datagram.hasPcr; });
+            if (next == queue.end()) {
+                // A full queue without a PCR must not hold up the writer for good
+                if (!stopping && queue.size() < options.maxQueuedDatagrams) {
+                    return false;
+                }
+                sendTime = now;
+                return true;
+            }
+
+            segmentLength = (next - queue.begin()) + 1;
+            segmentPosition = 0;
+            segmentEnd = getPcrTime(next->pcr);
+        }
+
+        ++segmentPosition;
+        sendTime = lastPcrTime + (segmentEnd - lastPcrTime) * segmentPosition / segmentLength;
+    }
+
+    if (now - sendTime > maxLag) {
+        fprintf(stderr, "[UDP] Sending fell %lld ms behind, restarting the clock\n",
+            static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - sendTime).count()));
+        Clock::duration shift = now - sendTime;
+        lastPcrTime += shift;
+        segmentEnd += shift;
+        sendTime = now;
+    }
+    return true;
+}
+
+TsUdpSender::Clock::time_point TsUdpSender::getPcrTime(uint64_t pcr) const {
+    uint64_t delta = (pcr + pcrWrap - lastPcr) % pcrWrap;
+    if (delta > maxPcrGap) {
+        return lastPcrTime;
+    }
+    return lastPcrTime + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(delta * 1000 / 27));
+}
+
+void TsUdpSender::sendBatch(std::vector<Datagram>& batch, const std::vector<Clock::time_point>& sendTimes) {
+    size_t count = sendTimes.size();
+    size_t offset = options.rtp ? 0 : rtpHeaderSize;
+
+    for (size_t i = 0; i < count && options.rtp; i++) {
+        uint8_t* header = batch[i].data.data();
+        // Timestamped with the send time on the 90 kHz clock
+        uint32_t timestamp = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(sendTimes[i] - startTime).count() * 9 / 100);
+        header[0] = 0x80;
+        header[1] = rtpPayloadTypeMp2t;
+        header[2] = static_cast<uint8_t>(rtpSequence >> 8);
+        header[3] = static_cast<uint8_t>(rtpSequence);
+        header[4] = static_cast<uint8_t>(timestamp >> 24);
+        header[5] = static_cast<uint8_t>(timestamp >> 16);
+        header[6] = static_cast<uint8_t>(timestamp >> 8);
+        header[7] = static_cast<uint8_t>(timestamp);
+        header[8] = static_cast<uint8_t>(rtpSsrc >> 24);
+        header[9] = static_cast<uint8_t>(rtpSsrc >> 16);
+        header[10] = static_cast<uint8_t>(rtpSsrc >> 8);
+        header[11] = static_cast<uint8_t>(rtpSsrc);
+        ++rtpSequence;
+    }
+
+    const sockaddr* addr = reinterpret_cast<const sockaddr*>(address.data());
+    size_t errors = 0;
+
+#ifdef __linux__
+    // One system call for the whole batch
+    std::vector<mmsghdr> messages(count);
+    std::vector<iovec> iovecs(count);
+    for (size_t i = 0; i < count; i++) {
+        iovecs[i].iov_base = batch[i].data.data() + offset;
+        iovecs[i].iov_len = rtpHeaderSize - offset + batch[i].packetCount * tsPacketSize;
+        messages[i] = mmsghdr{};
+        messages[i].msg_hdr.msg_name = const_cast<sockaddr*>(addr);
+        messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(address.size());
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    for (size_t sent = 0; sent < count; ) {
+        int result = sendmmsg(static_cast<NativeSocket>(socket), messages.data() + sent, static_cast<unsigned int>(count - sent), 0);
+        if (result <= 0) {
+            // Skips the datagram that failed
+            ++errors;
+            ++sent;
+            continue;
+        }
+        sent += result;
+    }
+#else
+    // Windows has no sendmmsg, so the batch goes out back to back
+    for (size_t i = 0; i < count; i++) {
+        const char* data = reinterpret_cast<const char*>(batch[i].data.data() + offset);
+        int size = static_cast<int>(rtpHeaderSize - offset + batch[i].packetCount * tsPacketSize);
+        if (sendto(static_cast<NativeSocket>(socket), data, size, 0, addr, static_cast<int>(address.size())) != size) {
+            ++errors;
+        }
+    }
+#endif
+
+    if (errors > 0 && sendErrors == 0) {
+        fprintf(stderr, "[UDP] Send failed\n");
+    }
+    sendErrors += errors;
+    datagramsSent += count - errors;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+// Sends the TS as UDP datagrams of 7 TS packets, optionally wrapped in RTP (RFC 2250), to a
+// unicast or multicast address. Datagrams go out from a thread of their own at the pace of the
+// PCR: a datagram with a PCR is sent when the PCR is due, and the ones in between are spread
+// evenly up to the next PCR. Whatever is due at a wakeup is sent as one batch.
+class TsUdpSender {
+public:
+    static constexpr size_t packetsPerDatagram = 7;
+
+    struct Options {
+        bool rtp{ false };
+        // Multicast TTL
+        int ttl{ 1 };
+        size_t maxBatchSize{ 32 };
+        // write() waits while this many datagrams are waiting to be sent
+        size_t maxQueuedDatagrams{ 16384 };
+    };
+
+    TsUdpSender();
+    ~TsUdpSender();
+
+    TsUdpSender(const TsUdpSender&) = delete;
+    TsUdpSender& operator=(const TsUdpSender&) = delete;
+
+    bool open(const std::string& host, uint16_t port, const Options& options);
+    void write(const uint8_t* data, size_t size);
+    // Sends what is left at its pace and closes the socket
+    void close();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t tsPacketSize = 188;
+    static constexpr size_t rtpHeaderSize = 12;
+
+    struct Datagram {
+        // Room for the RTP header is kept in front either way
+        std::array<uint8_t, rtpHeaderSize + packetsPerDatagram * tsPacketSize> data;
+        size_t packetCount{ 0 };
+        bool hasPcr{ false };
+        uint64_t pcr{ 0 };
+    };
+
+    void submit();
+    void worker();
+    // Works out when the datagram at the front of the queue is due
+    bool scheduleFront(Clock::time_point now, Clock::time_point& sendTime);
+    Clock::time_point getPcrTime(uint64_t pcr) const;
+    void sendBatch(std::vector<Datagram>& batch, const std::vector<Clock::time_point>& sendTimes);
+
+    Options options;
+    // SOCKET on Windows, a file descriptor elsewhere
+    intptr_t socket{ -1 };
+    std::vector<uint8_t> address;
+    Datagram current;
+    // The PID whose PCR paces the output, which is the first one seen with a PCR
+    uint16_t pcrPid{ 0x1fff };
+
+    std::mutex mutex;
+    std::condition_variable datagramQueued;
+    std::condition_variable datagramSent;
+    std::deque<Datagram> queue;
+    std::thread thread;
+    bool stopping{ false };
+
+    // Only touched by the sending thread
+    bool hasLastPcr{ false };
+    uint64_t lastPcr{ 0 };
+    Clock::time_point lastPcrTime;
+    // Spreads the datagrams between two PCRs
+    size_t segmentLength{ 0 };
+    size_t segmentPosition{ 0 };
+    Clock::time_point segmentEnd;
+    uint16_t rtpSequence{ 0 };
+    uint32_t rtpSsrc{ 0 };
+    Clock::time_point startTime;
+    uint64_t datagramsSent{ 0 };
+    uint64_t sendErrors{ 0 };
+    size_t maxQueueDepth{ 0 };
+
+};
@@ -0,0 +1,97 @@
+// Writes two segments of PCM with a gap between them through PcmBuffer and AacEncoder, encoding
+// after each one the way the transcoder does, and checks that the AAC frames of the second segment
+// are timed from its own timestamp. Built on its own against fdk-aac, for example:
+//   cl /O2 /EHsc /std:c++17 /I..\src aacTimestampTest.cpp ..\src\aacEncoder.cpp ..\src\pcmBuffer.cpp ..\src\pcmConvert.cpp fdk-aac.lib
+//   g++ -O2 -std=c++17 -I../src aacTimestampTest.cpp ../src/aacEncoder.cpp ../src/pcmBuffer.cpp ../src/pcmConvert.cpp -lfdk-aac -o aacTimestampTest
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include "pcmBuffer.h"
+#include "aacEncoder.h"
+
+namespace {
+
+constexpr uint32_t sampleRate = 48000;
+constexpr uint32_t channels = 2;
+// A segment of one second, and half a second missing before the next one
+constexpr uint64_t segmentDuration = 90000;
+constexpr uint64_t gap = 45000;
+
+std::vector<int32_t> makeTone(size_t frames) {
+    std::vector<int32_t> samples(frames * channels);
+    for (size_t i = 0; i < frames; i++) {
+        int32_t value = static_cast<int32_t>(std::sin(i * 2 * 3.14159265 * 440 / sampleRate) * 0x40000000);
+        for (uint32_t c = 0; c < channels; c++) {
+            samples[i * channels + c] = value;
+        }
+    }
+    return samples;
+}
+
+}
+
+int main() {
+    PcmBuffer pcm;
+    pcm.setFormat(sampleRate, channels);
+    AacEncoder encoder;
+
+    std::vector<int32_t> tone = makeTone(sampleRate * segmentDuration / 90000);
+    uint64_t firstTimestamp = 900000;
+    uint64_t secondTimestamp = firstTimestamp + segmentDuration + gap;
+
+    std::vector<AacFrame> first;
+    pcm.write(tone.data(), tone.size(), firstTimestamp);
+    if (encoder.encode(pcm, first) != 0) {
+        fprintf(stderr, "Encoding the first segment failed\n");
+        return 1;
+    }
+
+    std::vector<AacFrame> second;
+    pcm.write(tone.data(), tone.size(), secondTimestamp);
+    if (encoder.encode(pcm, second) != 0) {
+        fprintf(stderr, "Encoding the second segment failed\n");
+        return 1;
+    }
+    encoder.close();
+
+    uint64_t frameDuration = static_cast<uint64_t>(encoder.info.frameLength) * 90000 / sampleRate;
+    uint64_t delay = static_cast<uint64_t>(encoder.info.nDelay) * 90000 / sampleRate;
+
+    bool ok = true;
+    // The frames the encoder still held at the gap belong to the first segment
+    for (const auto& frame : first) {
+        if (frame.pts >= firstTimestamp + segmentDuration) {
+            fprintf(stderr, "A frame of the first segment is timed at %llu, past its end\n", static_cast<unsigned long long>(frame.pts));
+            ok = false;
+        }
+    }
+
+    size_t index = 0;
+    while (index < second.size() && second[index].pts < firstTimestamp + segmentDuration) {
+        ++index;
+    }
+    if (index == second.size()) {
+        fprintf(stderr, "No frames after the gap\n");
+        return 1;
+    }
+
+    uint64_t expected = secondTimestamp - delay;
+    uint64_t actual = second[index].pts;
+    printf("First frame after the gap: PTS %llu, expected %llu\n", static_cast<unsigned long long>(actual), static_cast<unsigned long long>(expected));
+    if (actual != expected) {
+        ok = false;
+    }
+    for (size_t i = index + 1; i < second.size(); i++) {
+        uint64_t pts = expected + (i - index) * static_cast<uint64_t>(encoder.info.frameLength) * 90000 / sampleRate;
+        if (second[i].pts != pts) {
+            fprintf(stderr, "Frame %zu after the gap is timed at %llu instead of %llu\n", i - index, static_cast<unsigned long long>(second[i].pts), static_cast<unsigned long long>(pts));
+            ok = false;
+            break;
+        }
+    }
+    printf("%zu + %zu frames of %llu ticks\n", first.size(), second.size(), static_cast<unsigned long long>(frameDuration));
+
+    printf(ok ? "OK\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+// Runs the key store and CAS client against a stand-in CAS server on localhost that answers slowly,
+// fails now and then, or never answers in time. It checks the keys and retries, and shows how long
+// the demux thread is held up by a key request. Built on its own, for example:
+//   cl /O2 /EHsc /std:c++17 /I..\src casClientTest.cpp ..\src\keyStore.cpp ..\src\casClient.cpp ..\src\config.cpp
+//   g++ -O2 -std=c++17 -I../src casClientTest.cpp ../src/keyStore.cpp ../src/casClient.cpp ../src/config.cpp -lpthread -o casClientTest
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "httplib.h"
+#include "config.h"
+#include "keyStore.h"
+#include "casClient.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int port = 18765;
+constexpr auto serverLatency = std::chrono::milliseconds(200);
+constexpr size_t keyCount = 4;
+
+// The first request for this KID fails, the retry succeeds
+constexpr uint8_t flakyKid = 0xF0;
+// Requests for this KID are answered after the client has given up
+constexpr uint8_t slowKid = 0xF1;
+
+std::string toHex(const atsc3::CasKey& value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (uint8_t byte : value) {
+        hex.push_back(digits[byte >> 4]);
+        hex.push_back(digits[byte & 0xF]);
+    }
+    return hex;
+}
+
+atsc3::CasKey makeKid(uint8_t id) {
+    atsc3::CasKey kid{};
+    kid.fill(id);
+    return kid;
+}
+
+atsc3::CasKey makeKey(const atsc3::CasKey& kid) {
+    atsc3::CasKey key = kid;
+    for (auto& byte : key) {
+        byte ^= 0x5A;
+    }
+    return key;
+}
+
+// Calls acquire() the way the demux thread does until the key is no longer pending
+atsc3::KeyStatus waitForKey(const atsc3::CasKey& kid, atsc3::CasKey& key, Clock::duration& maxStall) {
+    std::vector<uint8_t> ecm(64, 0xEC);
+    uint64_t completed = atsc3::CasClient::instance().getCompletedCount();
+    while (true) {
+        auto start = Clock::now();
+        atsc3::KeyStatus status = atsc3::KeyStore::instance().acquire(kid, ecm, key);
+        maxStall = std::max(maxStall, Clock::now() - start);
+        if (status != atsc3::KeyStatus::Pending) {
+            return status;
+        }
+        completed = atsc3::CasClient::instance().waitForCompletion(completed, std::chrono::seconds(1));
+    }
+}
+
+double toMs(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}
+
+int main() {
+    std::atomic<uint32_t> flakyRequests{ 0 };
+
+    httplib::Server server;
+    server.Post("/ecm", [&](const httplib::Request& req, httplib::Response& res) {
+        if (req.body.size() < 16) {
+            res.status = 400;
+            return;
+        }
+
+        atsc3::CasKey kid;
+        std::copy(req.body.begin(), req.body.begin() + 16, kid.begin());
+        if (kid[0] == flakyKid && flakyRequests++ == 0) {
+            res.status = 500;
+            return;
+        }
+        std::this_thread::sleep_for(kid[0] == slowKid ? std::chrono::milliseconds(config.casTimeoutMs * 2) : serverLatency);
+
+        res.set_content(toHex(kid) + "\n" + toHex(makeKey(kid)) + "\n", "text/plain");
+    });
+    if (!server.bind_to_port("127.0.0.1", port)) {
+        fprintf(stderr, "Unable to bind the stand-in CAS server to port %d\n", port);
+        return 1;
+    }
+    std::thread serverThread([&]() {
+        server.listen_after_bind();
+    });
+
+    config.casServerUrl = "http://127.0.0.1:" + std::to_string(port) + "/ecm";
+    config.casTimeoutMs = 500;
+    config.casRetries = 1;
+
+    bool ok = true;
+    Clock::duration maxStall{ 0 };
+
+    // Every KID of a crypto period change is requested at once, as the services of a broadcast do
+    auto start = Clock::now();
+    std::vector<uint8_t> ecm(64, 0xEC);
+    for (size_t i = 0; i < keyCount; i++) {
+        atsc3::CasKey key;
+        auto callStart = Clock::now();
+        atsc3::KeyStore::instance().acquire(makeKid(static_cast<uint8_t>(i)), ecm, key);
+        maxStall = std::max(maxStall, Clock::now() - callStart);
+    }
+    for (size_t i = 0; i < keyCount; i++) {
+        atsc3::CasKey kid = makeKid(static_cast<uint8_t>(i));
+        atsc3::CasKey key;
+        if (waitForKey(kid, key, maxStall) != atsc3::KeyStatus::Ready || key != makeKey(kid)) {
+            fprintf(stderr, "Wrong or missing key for KID %s\n", toHex(kid).c_str());
+            ok = false;
+        }
+    }
+    auto elapsed = Clock::now() - start;
+
+    printf("%zu keys with %lld ms server latency: all in %.0f ms, the demux thread was held up for %.3f ms at most\n",
+        keyCount, static_cast<long long>(serverLatency.count()), toMs(elapsed), toMs(maxStall));
+    printf("A blocking request per KID would have held it up for %lld ms\n",
+        static_cast<long long>(serverLatency.count() * keyCount));
+
+    {
+        atsc3::CasKey kid = makeKid(flakyKid);
+        atsc3::CasKey key;
+        if (waitForKey(kid, key, maxStall) != atsc3::KeyStatus::Ready || key != makeKey(kid) || flakyRequests != 2) {
+            fprintf(stderr, "The key was not acquired on the retry after a failed request\n");
+            ok = false;
+        }
+    }
+
+    {
+        atsc3::CasKey kid = makeKid(slowKid);
+        atsc3::CasKey key;
+        auto slowStart = Clock::now();
+        if (waitForKey(kid, key, maxStall) != atsc3::KeyStatus::Failed) {
+            fprintf(stderr, "A request past the timeout did not fail\n");
+            ok = false;
+        }
+        printf("A server that does not answer in time failed the key after %.0f ms (%u attempt(s) of %u ms)\n",
+            toMs(Clock::now() - slowStart), config.casRetries + 1, config.casTimeoutMs);
+    }
+
+    server.stop();
+    serverThread.join();
+
+    printf(ok ? "OK\n" : "FAILED\n");
+    return ok ? 0 : 1;
+}